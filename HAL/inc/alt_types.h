@@ -41,8 +41,14 @@ typedef signed char  alt_8;
 typedef unsigned char  alt_u8;
 typedef signed short alt_16;
 typedef unsigned short alt_u16;
+#ifdef __LP64__
+/* host builds (ALT_HOST): keep the 32-bit types 32 bits wide */
+typedef signed int alt_32;
+typedef unsigned int alt_u32;
+#else
 typedef signed long alt_32;
 typedef unsigned long alt_u32;
+#endif
 typedef long long alt_64;
 typedef unsigned long long alt_u64;
 #endif
@@ -0,0 +1,115 @@
+// #################################################################################################
+// # << RIDECORE: clint.h - Machine Timer HW Driver >>                                           #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file clint.h
+ * @author ncik20
+ * @brief Machine timer driver: the 64-bit mtime counter and the mtimecmp
+ * compare register of the CLINT.
+ *
+ * The machine timer interrupt (MTI) is pending while mtime >= mtimecmp
+ * and enters through entry 7 of the vector table. mtime counts at the
+ * core clock, so cycle values from alt_time.h apply to it.
+ *
+ * @note The register offsets are visible to assembly code.
+ **************************************************************************/
+
+#ifndef clint_h
+#define clint_h
+
+#include "ridecore.h"
+
+/*
+ * Register indices (IORD/IOWR register numbers)
+ */
+#define CLINT_REG_MTIME_LO     0
+#define CLINT_REG_MTIME_HI     1
+#define CLINT_REG_MTIMECMP_LO  2
+#define CLINT_REG_MTIMECMP_HI  3
+
+#ifndef ALT_ASM_SRC
+
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * @brief Disable the machine timer interrupt and park mtimecmp at its
+ * maximum, so MTI stays clear.
+ **/
+void clint_init(void);
+
+/**
+ * @brief Read the 64-bit mtime counter.
+ **/
+alt_u64 clint_get_time(void);
+
+/**
+ * @brief Set mtimecmp. MTI is raised once mtime reaches \em timecmp.
+ **/
+void clint_set_timecmp(alt_u64 timecmp);
+
+/**
+ * @brief Let the machine timer interrupt the CPU (mie.MTIE).
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE clint_enable_irq(void)
+{
+#ifndef ALT_HOST
+  asm volatile ("csrs mie, %[mtie]" : : [mtie] "r" (1 << CSR_MIE_MTIE));
+#endif
+}
+
+/**
+ * @brief Mask the machine timer interrupt.
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE clint_disable_irq(void)
+{
+#ifndef ALT_HOST
+  asm volatile ("csrc mie, %[mtie]" : : [mtie] "r" (1 << CSR_MIE_MTIE));
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif // clint_h
@@ -0,0 +1,200 @@
+// #################################################################################################
+// # << RIDECORE: plic.h - Platform-Level Interrupt Controller >>                                #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file plic.h
+ * @author ncik20
+ * @brief PLIC driver: per-source trigger, priority and enable, the
+ * priority threshold and the claim/complete handshake.
+ *
+ * The PLIC has one 32-bit register per function, each holding a field for
+ * every source. The driver keeps a shadow copy of the writable registers
+ * in #plic_shadow, so changing one source is a store of the updated
+ * shadow word instead of an MMIO read-modify-write. Claim and complete
+ * are single accesses to PLIC_CLAIM: plic_claim()/plic_complete() for C,
+ * the plic_claim/plic_complete macros for the interrupt entry in
+ * interrupt.S.
+ *
+ * @note The register and shadow offsets are visible to assembly code.
+ **************************************************************************/
+
+#ifndef plic_h
+#define plic_h
+
+#include "ridecore.h"
+
+/*
+ * Register indices (IORD/IOWR register numbers)
+ */
+// bit n: source n is edge (1) or level (0) triggered
+#define PLIC_REG_TRIGGER    0
+// 4 bits per source, source n in bits [4n+3:4n]
+#define PLIC_REG_PRIORITY   1
+// bit n: source n is enabled
+#define PLIC_REG_ENABLE     2
+// sources with a priority at or below the threshold are masked
+#define PLIC_REG_THRESHOLD  3
+// reads claim the highest-priority pending source, writes complete
+#define PLIC_REG_CLAIM      4
+
+#define PLIC_CLAIM          (PLIC_BASE + PLIC_REG_CLAIM * 4)
+
+#define PLIC_NUM_SOURCES    7
+#define PLIC_PRIORITY_BITS  4
+#define PLIC_PRIORITY_MAX   15
+// priority given to every source by plic_init()
+#define PLIC_PRIORITY_DEFAULT 1
+
+/*
+ * plic_shadow field offsets for assembly code
+ */
+#define PLIC_SHADOW_TRIGGER    0
+#define PLIC_SHADOW_PRIORITY   4
+#define PLIC_SHADOW_ENABLE     8
+#define PLIC_SHADOW_THRESHOLD  12
+
+#ifdef ALT_ASM_SRC
+
+/*
+ * plic_claim()/plic_complete() for assembly code, \tmp is clobbered
+ */
+	.macro plic_claim rd, tmp
+	li \tmp, PLIC_CLAIM
+	lw \rd, 0(\tmp)
+	.endm
+
+	.macro plic_complete tmp
+	li \tmp, PLIC_CLAIM
+	sw x0, 0(\tmp)
+	.endm
+
+#else
+
+#include "io.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * Last values written to the PLIC registers.
+ */
+typedef struct plic_regs
+{
+	alt_u32 trigger;
+	alt_u32 priority;
+	alt_u32 enable;
+	alt_u32 threshold;
+} plic_regs;
+
+extern plic_regs plic_shadow;
+
+/**
+ * @brief Reset the PLIC: every source level triggered, disabled and at
+ * PLIC_PRIORITY_DEFAULT, threshold 0.
+ **/
+void plic_init(void);
+
+/**
+ * @brief Select edge (\em edge != 0) or level triggering for source \em id.
+ **/
+void plic_set_trigger(alt_u32 id, int edge);
+
+/**
+ * @brief Set the priority (0 .. PLIC_PRIORITY_MAX) of source \em id. A
+ * source with priority 0 never interrupts.
+ **/
+void plic_set_priority(alt_u32 id, alt_u32 priority);
+
+/**
+ * @brief Allow source \em id to interrupt.
+ **/
+void plic_enable(alt_u32 id);
+
+/**
+ * @brief Mask source \em id. Safe to call from an interrupt handler.
+ **/
+void plic_disable(alt_u32 id);
+
+/**
+ * @brief Mask all sources with a priority at or below \em threshold.
+ **/
+void plic_set_threshold(alt_u32 threshold);
+
+/**
+ * @brief Priority of source \em id, from the shadow registers.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE plic_get_priority(alt_u32 id)
+{
+  return (plic_shadow.priority >> (id << 2)) & PLIC_PRIORITY_MAX;
+}
+
+/**
+ * @brief Current priority threshold, from the shadow registers.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE plic_get_threshold(void)
+{
+  return plic_shadow.threshold;
+}
+
+/**
+ * @brief Claim the highest-priority pending source.
+ *
+ * @return the source number.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE plic_claim(void)
+{
+  return IORD_32DIRECT(PLIC_CLAIM, 0);
+}
+
+/**
+ * @brief Complete the most recent claim. The source can interrupt again
+ * afterwards; nested claims are completed in reverse order.
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE plic_complete(void)
+{
+  IOWR_32DIRECT(PLIC_CLAIM, 0, 0);
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif // plic_h
@@ -45,17 +45,63 @@
 #include "alt_types.h"
 
 #define CSR_MSTATUS_MIE 3
+// mie bits
+#define CSR_MIE_MTIE    7
+#define CSR_MIE_MEIE    11
 
 /*
- * ps2_keyboard_0 configuration
+ * Machine-mode CSR addresses
+ */
+#define CSR_MSTATUS  0x300
+#define CSR_MIE      0x304
+#define CSR_MTVEC    0x305
+#define CSR_MEPC     0x341
+#define CSR_MCAUSE   0x342
+#define CSR_MCYCLE   0xB00
+#define CSR_MCYCLEH  0xB80
+
+/*
+ * mcause interrupt codes
+ */
+#define MCAUSE_INTERRUPT  0x80000000
+#define MCAUSE_MSI        3
+#define MCAUSE_MTI        7
+#define MCAUSE_MEI        11
+
+/*
+ * PLIC configuration
  *
  */
 
 #define PLIC_BASE 0x40000000
 
+/*
+ * Machine timer (CLINT mtime/mtimecmp) configuration
+ *
+ * The baseline system has no timer, so this is not taken from the RTL: it
+ * is the free 0x100 slot between the PLIC and the PS/2 port in the
+ * peripheral window, with mtime at +0 and mtimecmp at +8 (clint.h). A
+ * core that places the CLINT elsewhere changes it here; tools/rvsim
+ * models it at this address. Without it main.c polls device detection
+ * instead of waiting for the timer.
+ */
+
+#define CLINT_BASE 0x40000100
+
+/*
+ * ps2_keyboard_0 configuration
+ *
+ */
+
 #define PS2_KEYBOARD_0_NAME "/dev/ps2_keyboard_0"
 #define PS2_KEYBOARD_0_BASE 0x40000200
-#define PS2_KEYBOARD_0_IRQ 0
+// PLIC source number (bit index in the PLIC enable register)
+#define PS2_KEYBOARD_0_IRQ 6
+
+/*
+ * Everything below is C only.
+ */
+#ifndef ALT_ASM_SRC
 
 /**********************************************************************//**
  * Prototype for "after-main handler". This function is called if main() returns.
@@ -65,6 +111,20 @@
  **************************************************************************/
 extern int __neorv32_crt0_after_main(alt_32 return_code) __attribute__ ((weak));
 
+/*
+ * Cycles spent in startup.S from reset to the call of main(): register
+ * clear, .data/.bss init and constructors.
+ */
+extern alt_u32 alt_boot_cycles;
+
+#ifdef ALT_HOST
+/*
+ * Host build: the bus access and CPU functions below are replaced by
+ * versions backed by the software MMIO model in host/.
+ */
+#include "ridecore_host.h"
+#else
+
 
 /**********************************************************************//**
  * Store unsigned word to address space if atomic access reservation is still valid.
@@ -249,6 +309,43 @@ inline void ALT_ALWAYS_INLINE ridecore_cpu_csr_write(const int csr_id, alt_u32 d
 }
 
 
+/**********************************************************************//**
+ * Get low word of the cycle counter (mcycle CSR).
+ *
+ * @note Wraps around every 2^32 cycles, use for measuring short intervals.
+ *
+ * @return Current cycle count, low word (alt_u32).
+ **************************************************************************/
+inline alt_u32 ALT_ALWAYS_INLINE ridecore_cpu_get_cycle(void) {
+
+  register alt_u32 cycle;
+
+  asm volatile ("csrr %[result], mcycle" : [result] "=r" (cycle));
+
+  return cycle;
+}
+
+
+/**********************************************************************//**
+ * Get the full 64-bit cycle counter (mcycleh:mcycle CSRs).
+ *
+ * @return Current cycle count (alt_u64).
+ **************************************************************************/
+inline alt_u64 ALT_ALWAYS_INLINE ridecore_cpu_get_cycle64(void) {
+
+  register alt_u32 hi, lo, hi2;
+
+  // re-read if the low word wrapped between the two accesses
+  do {
+    asm volatile ("csrr %[result], mcycleh" : [result] "=r" (hi));
+    asm volatile ("csrr %[result], mcycle" : [result] "=r" (lo));
+    asm volatile ("csrr %[result], mcycleh" : [result] "=r" (hi2));
+  } while (hi != hi2);
+
+  return ((alt_u64)hi << 32) | (alt_u64)lo;
+}
+
+
 /**********************************************************************//**
  * Put CPU into "sleep" mode.
  *
@@ -308,4 +405,8 @@ inline void ALT_ALWAYS_INLINE ridecore_cpu_mret(void) {
   asm volatile ("mret");
 }
 
+#endif // ALT_HOST
+
+#endif // ALT_ASM_SRC
+
 #endif // ridecore_h
@@ -0,0 +1,153 @@
+// #################################################################################################
+// # << RIDECORE: ridecore_host.h - Host build CPU functions >>                                  #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file ridecore_host.h
+ * @author ncik20
+ * @brief Host (ALT_HOST) replacements of the ridecore.h CPU functions.
+ *
+ * Included by ridecore.h instead of the inline assembly versions. Bus
+ * accesses go to the software MMIO model in host/mmio_mock.c, the cycle
+ * counter reads the host clock in nanoseconds.
+ **************************************************************************/
+
+#ifndef ridecore_host_h
+#define ridecore_host_h
+
+#include <stdint.h>
+
+/*
+ * Provided by host/mmio_mock.c
+ */
+extern alt_u32 host_mmio_read(alt_u32 addr);
+extern void host_mmio_write(alt_u32 addr, alt_u32 wdata, alt_u32 size);
+extern alt_u64 host_cpu_cycle(void);
+extern alt_u32 host_cpu_mstatus;
+
+// device addresses are 32-bit, host pointers are not
+#define HOST_MMIO_ADDR(addr) ((alt_u32)(uintptr_t)(addr))
+
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE ridecore_cpu_store_conditional(void* addr, alt_u32 wdata) {
+
+  return 1; // always failing
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE __builtin_stwio(void* addr, alt_u32 wdata) {
+
+  host_mmio_write(HOST_MMIO_ADDR(addr), wdata, 4);
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE __builtin_sthio(void* addr, alt_u16 wdata) {
+
+  host_mmio_write(HOST_MMIO_ADDR(addr), wdata, 2);
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE __builtin_stbio(void* addr, alt_u8 wdata) {
+
+  host_mmio_write(HOST_MMIO_ADDR(addr), wdata, 1);
+}
+
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE __builtin_ldwio(void* addr) {
+
+  return host_mmio_read(HOST_MMIO_ADDR(addr));
+}
+
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE ridecore_cpu_load_reservate_word(void* addr) {
+
+  return host_mmio_read(HOST_MMIO_ADDR(addr));
+}
+
+static ALT_INLINE alt_u16 ALT_ALWAYS_INLINE __builtin_ldhuio(void* addr) {
+
+  alt_u32 a = HOST_MMIO_ADDR(addr);
+
+  return (alt_u16)(host_mmio_read(a & ~3) >> ((a & 2) << 3));
+}
+
+static ALT_INLINE alt_u8 ALT_ALWAYS_INLINE __builtin_ldbuio(void* addr) {
+
+  alt_u32 a = HOST_MMIO_ADDR(addr);
+
+  return (alt_u8)(host_mmio_read(a & ~3) >> ((a & 3) << 3));
+}
+
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE ridecore_cpu_csr_read(const int csr_id) {
+
+  return (csr_id == CSR_MSTATUS) ? host_cpu_mstatus : 0;
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_csr_write(const int csr_id, alt_u32 data) {
+
+  if (csr_id == CSR_MSTATUS)
+    host_cpu_mstatus = data;
+}
+
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE ridecore_cpu_get_cycle(void) {
+
+  return (alt_u32)host_cpu_cycle();
+}
+
+static ALT_INLINE alt_u64 ALT_ALWAYS_INLINE ridecore_cpu_get_cycle64(void) {
+
+  return host_cpu_cycle();
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_sleep(void) {
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_eint(void) {
+
+  host_cpu_mstatus |= 1 << CSR_MSTATUS_MIE;
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_dint(void) {
+
+  host_cpu_mstatus &= ~(1 << CSR_MSTATUS_MIE);
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_breakpoint(void) {
+
+  __builtin_trap();
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_env_call(void) {
+}
+
+static ALT_INLINE void ALT_ALWAYS_INLINE ridecore_cpu_mret(void) {
+}
+
+#endif // ridecore_host_h
@@ -87,28 +87,54 @@ struct alt_dev_s {
   int (*ioctl) (alt_fd* fd, int req, void* arg);
 };
 
+/*
+ * alt_fd.fd_flags: read() and write() return -EWOULDBLOCK instead of
+ * waiting (same value as newlib's O_NONBLOCK)
+ */
+#define ALT_O_NONBLOCK 0x4000
+
+/*
+ * Registered devices, an open-addressed hash table on the device name.
+ * ALT_MAX_DEV must be a power of two.
+ */
+#ifndef ALT_MAX_DEV
+#define ALT_MAX_DEV 8
+#endif
+
+typedef struct alt_dev_table_s
+{
+  alt_dev* slot[ALT_MAX_DEV];
+  alt_u32  count;
+} alt_dev_table;
+
+extern alt_dev_table alt_dev_list;
+
 /*
  * Functions used to register device for access through the C standard 
  * library.
  *
- * The only difference between alt_dev_reg() and alt_fs_reg() is the 
- * interpretation that open() places on the device name. In the case of
- * alt_dev_reg the device is assumed to be a particular character device,
- * and so there must be an exact match in the name for open to succeed. 
- * In the case of alt_fs_reg() the name of the device is treated as the
- * mount point for a directory, and so any call to open() where the name 
- * is the root of the device filename will succeed. 
+ * alt_dev_reg() adds a character device; open() needs an exact match
+ * of its name. alt_find_dev() hashes the name once and finds the device
+ * in a constant number of probes, however many are registered. Both
+ * return -EEXIST/-ENOSPC or NULL on failure.
  */
+extern int alt_dev_reg (alt_dev* dev);
+extern alt_dev* alt_find_dev (const char* name, alt_dev_table* list);
+
 /*
-extern int alt_fs_reg  (alt_dev* dev); 
+ * Bind \em fd to the device \em name and call its open(), if any.
+ * \em flags may contain ALT_O_NONBLOCK. Returns 0, -ENODEV, or the
+ * error of the device's open().
+ */
+extern int alt_fd_open (alt_fd* fd, const char* name, int flags);
 
-static ALT_INLINE int alt_dev_reg (alt_dev* dev)
-{
-  extern alt_llist alt_dev_list;
+/*
+ * read()/write() through the device of \em fd. Return the number of
+ * bytes moved, or a negative errno value.
+ */
+extern int alt_read (alt_fd* fd, char* ptr, int len);
+extern int alt_write (alt_fd* fd, const char* ptr, int len);
 
-  return alt_dev_llist_insert ((alt_dev_llist*) dev, &alt_dev_list);
-}
-*/
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,100 @@
+// #################################################################################################
+// # << RIDECORE: alt_format.h - Integer Formatting >>                                           #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_format.h
+ * @author ncik20
+ * @brief Decimal and hexadecimal formatting of u32/u64 without division.
+ *
+ * rv32i has no divide instruction, and a '/ 10' or '% 10' becomes a call
+ * to a bit-serial division loop. The decimal conversions here divide by
+ * 10 with the shift-and-add reciprocal of 1/10 (alt_udiv10() in
+ * alt_muldiv.h), which takes a dozen ALU operations per digit. A u64
+ * value uses the 64-bit reciprocal only until it fits in 32 bits.
+ * Hexadecimal needs shifts only.
+ **************************************************************************/
+
+#ifndef __ALT_FORMAT_H__
+#define __ALT_FORMAT_H__
+
+#include "../alt_types.h"
+#include "alt_muldiv.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * Most digits of each conversion, without padding
+ */
+#define ALT_FMT_U32_DEC_MAX  10
+#define ALT_FMT_U64_DEC_MAX  20
+#define ALT_FMT_U32_HEX_MAX  8
+#define ALT_FMT_U64_HEX_MAX  16
+
+/**
+ * @brief Write \em value in decimal to \em buf, right aligned in a field
+ * of at least \em width characters filled with \em pad on the left
+ * ('0' or ' '), and NUL terminate it.
+ *
+ * @return the number of characters written, without the NUL. \em buf
+ * must hold max(width, ALT_FMT_U32_DEC_MAX) + 1 characters.
+ **/
+alt_u32 alt_fmt_u32_dec(char* buf, alt_u32 value, alt_u32 width, char pad);
+
+/**
+ * @brief alt_fmt_u32_dec() for a u64, up to ALT_FMT_U64_DEC_MAX digits.
+ **/
+alt_u32 alt_fmt_u64_dec(char* buf, alt_u64 value, alt_u32 width, char pad);
+
+/**
+ * @brief Write \em value in lower case hexadecimal, without a prefix,
+ * padded like alt_fmt_u32_dec().
+ **/
+alt_u32 alt_fmt_u32_hex(char* buf, alt_u32 value, alt_u32 width, char pad);
+
+/**
+ * @brief alt_fmt_u32_hex() for a u64, up to ALT_FMT_U64_HEX_MAX digits.
+ **/
+alt_u32 alt_fmt_u64_hex(char* buf, alt_u64 value, alt_u32 width, char pad);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __ALT_FORMAT_H__ */
@@ -0,0 +1,110 @@
+// #################################################################################################
+// # << RIDECORE: alt_hist.h - Log2 Latency Histogram >>                                         #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_hist.h
+ * @author ncik20
+ * @brief Log2-bucketed histogram of cycle counts.
+ *
+ * Bucket n counts values in [2^n, 2^(n+1)), bucket 0 also takes 0 and
+ * the last bucket everything from 2^(ALT_HIST_BUCKETS-1) up. Adding a
+ * value takes a handful of shifts and compares and no division, so it is
+ * cheap enough for the interrupt and decode paths.
+ **************************************************************************/
+
+#ifndef __ALT_HIST_H__
+#define __ALT_HIST_H__
+
+#include "../alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#define ALT_HIST_BUCKETS 16
+
+typedef struct alt_hist
+{
+	/// @brief sum of all values, total / count is the mean
+	alt_u64 total;
+	alt_u32 count;
+	alt_u32 min;
+	alt_u32 max;
+	alt_u32 bucket[ALT_HIST_BUCKETS];
+} alt_hist;
+
+#define ALT_HIST_INIT { 0, 0, 0xFFFFFFFF, 0, { 0 } }
+
+/**
+ * @brief floor(log2(v)), 0 for v = 0.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_log2(alt_u32 v)
+{
+  alt_u32 n = 0;
+
+  if (v >> 16) { v >>= 16; n += 16; }
+  if (v >> 8)  { v >>= 8;  n += 8; }
+  if (v >> 4)  { v >>= 4;  n += 4; }
+  if (v >> 2)  { v >>= 2;  n += 2; }
+  if (v >> 1)  { n += 1; }
+  return n;
+}
+
+/**
+ * @brief Count \em value in \em hist.
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE alt_hist_add(alt_hist* hist, alt_u32 value)
+{
+  alt_u32 b = alt_log2(value);
+
+  if (b >= ALT_HIST_BUCKETS)
+    b = ALT_HIST_BUCKETS - 1;
+  hist->bucket[b]++;
+  hist->count++;
+  hist->total += value;
+  if (value < hist->min)
+    hist->min = value;
+  if (value > hist->max)
+    hist->max = value;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __ALT_HIST_H__ */
@@ -0,0 +1,194 @@
+// #################################################################################################
+// # << RIDECORE: alt_irq.h - Interrupt Dispatch HW Driver >>                                    #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+/**********************************************************************//**
+ * @file alt_irq.h
+ * @author ncik20
+ * @brief Vectored interrupt dispatch: trap vector table and per-source
+ * handler registration.
+ *
+ * mtvec points to alt_irq_vector_table (interrupt.S) in vectored mode.
+ * The machine external interrupt entry claims the PLIC, dispatches the
+ * claimed source number through #alt_irq with a single indexed load and
+ * completes the claim. Adding a source does not add work to the others.
+ **************************************************************************/
+
+#ifndef __ALT_IRQ_H__
+#define __ALT_IRQ_H__
+
+#include "../ridecore.h"
+#include "../plic.h"
+
+/*
+ * Number of entries of the handler table. Must be a power of two, the
+ * claimed source number is masked with (ALT_NIRQ - 1).
+ */
+#define ALT_NIRQ 8
+
+/*
+ * Size of one alt_irq_handler entry (log2), used by the dispatcher.
+ */
+#define ALT_IRQ_HANDLER_SHIFT 3
+
+/*
+ * 1: priority-preemptive nesting. Handlers run with interrupts enabled
+ * and the PLIC threshold at their source's priority, so a source of
+ * higher priority interrupts them. 0: handlers run with interrupts
+ * disabled. Set with 'make IRQ_NESTING=1'.
+ */
+#ifndef ALT_IRQ_NESTING
+#define ALT_IRQ_NESTING 0
+#endif
+
+#ifndef ALT_ASM_SRC
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * @brief Interrupt service routine. Called with interrupts disabled, or
+ * with ALT_IRQ_NESTING preemptible by sources of higher priority.
+ *
+ * @param isr_context -- the context registered with the handler.
+ * @param id -- the PLIC source number that was claimed.
+ **/
+typedef void (*alt_isr_func)(void* isr_context, alt_u32 id);
+
+/*
+ * Saved interrupt enable state, see alt_irq_disable_all().
+ */
+typedef alt_u32 alt_irq_context;
+
+/*
+ * Handler table entry.
+ */
+typedef struct alt_irq_handler
+{
+	alt_isr_func handler;
+	void*        context;
+} alt_irq_handler;
+
+/*
+ * Handler table, indexed by PLIC source number.
+ */
+extern alt_irq_handler alt_irq[ALT_NIRQ];
+
+/*
+ * mcycle (low word) sampled at the entry of the last external interrupt.
+ * With ALT_IRQ_NESTING only an interrupt taken from thread level sets it,
+ * not one that preempts a handler, so it stays the entry of the
+ * outermost interrupt.
+ */
+extern volatile alt_u32 alt_irq_entry_cycle;
+
+/*
+ * With ALT_IRQ_NESTING: worst case cycles from the first instruction of
+ * alt_irq_entry to the call of the handler (register save, claim and
+ * threshold update), per priority level of the claimed source. Time the
+ * source spent pending before that entry is not included: while
+ * interrupts were disabled, or while a handler at or above its priority
+ * ran, nothing records when it was raised.
+ */
+extern alt_u32 alt_irq_max_latency[PLIC_PRIORITY_MAX + 1];
+
+/*
+ * Trap vector table (interrupt.S).
+ */
+extern void alt_irq_vector_table(void);
+
+/**
+ * @brief Point mtvec at the vector table in vectored mode.
+ **/
+void alt_irq_init(void);
+
+/**
+ * @brief Register an interrupt handler for a PLIC source.
+ *
+ * @param id -- the PLIC source number.
+ * @param context -- passed to \em handler on every interrupt.
+ * @param handler -- the interrupt handler, NULL restores the default handler.
+ *
+ * @return 0 on success, or \c -EINVAL if \em id is out of range.
+ **/
+int alt_irq_register(alt_u32 id, void* context, alt_isr_func handler);
+
+/**
+ * @brief Default handler of unregistered sources. Disables the source in
+ * the PLIC so that a level-triggered line cannot lock up the CPU.
+ **/
+void alt_irq_default_isr(void* context, alt_u32 id);
+
+/**
+ * @brief Disable global CPU interrupts.
+ *
+ * @return the previous interrupt enable state, to be passed to alt_irq_enable_all().
+ **/
+static ALT_INLINE alt_irq_context ALT_ALWAYS_INLINE alt_irq_disable_all(void)
+{
+  alt_irq_context context;
+
+#ifdef ALT_HOST
+  context = host_cpu_mstatus;
+  host_cpu_mstatus &= ~(1 << CSR_MSTATUS_MIE);
+#else
+  asm volatile ("csrrci %[ctx], mstatus, %[mie]" : [ctx] "=r" (context) : [mie] "i" (1 << CSR_MSTATUS_MIE));
+#endif
+
+  return context & (1 << CSR_MSTATUS_MIE);
+}
+
+/**
+ * @brief Restore the global CPU interrupt state saved by alt_irq_disable_all().
+ *
+ * @param context -- the value returned by alt_irq_disable_all().
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE alt_irq_enable_all(alt_irq_context context)
+{
+#ifdef ALT_HOST
+  host_cpu_mstatus |= context;
+#else
+  asm volatile ("csrs mstatus, %[ctx]" : : [ctx] "r" (context));
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif /* __ALT_IRQ_H__ */
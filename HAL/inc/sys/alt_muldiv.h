@@ -0,0 +1,193 @@
+// #################################################################################################
+// # << RIDECORE: alt_muldiv.h - Software Multiply/Divide >>                                     #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_muldiv.h
+ * @author ncik20
+ * @brief Software multiply and divide for rv32i.
+ *
+ * rv32i has no M extension, so gcc turns every '*', '/' and '%' on
+ * 32-bit operands into a call to __mulsi3, __udivsi3, __umodsi3,
+ * __divsi3 or __modsi3. The firmware is linked without libgcc; these
+ * come from HAL/src/alt_muldiv.c instead. Their cost follows the size
+ * of the operands: a multiply loops over the bits of the smaller factor,
+ * a divide over the bits of the quotient.
+ *
+ * A division by a constant does not need the call at all:
+ * ALT_UDIV_CONST() and ALT_UMOD_CONST() turn powers of two into shifts
+ * and masks and 3, 5, 7 and 10 into shift-and-add reciprocals, and fall
+ * back to the runtime for any other divisor.
+ **************************************************************************/
+
+#ifndef __ALT_MULDIV_H__
+#define __ALT_MULDIV_H__
+
+#include "../alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * The libgcc runtime entry points, called by gcc-generated code. Division
+ * by zero gives what the M extension would: an all-ones quotient and the
+ * dividend as the remainder. The remainder takes the sign of the dividend.
+ */
+alt_32 __mulsi3(alt_32 a, alt_32 b);
+alt_u32 __udivsi3(alt_u32 n, alt_u32 d);
+alt_u32 __umodsi3(alt_u32 n, alt_u32 d);
+alt_32 __divsi3(alt_32 n, alt_32 d);
+alt_32 __modsi3(alt_32 n, alt_32 d);
+
+/**
+ * @brief \em n / \em d and \em n % \em d with one call.
+ **/
+alt_u32 alt_udivmod(alt_u32 n, alt_u32 d, alt_u32* rem);
+
+/*
+ * Shift-and-add reciprocals: q is an estimate of n * (1/d) built from
+ * shifted copies of n, a few short at most; the remainder n - q * d
+ * then corrects it. Each returns n / d with n % d in *rem, and matches
+ * the division for all 2^32 inputs.
+ */
+
+/**
+ * @brief \em n / 3, q = n * 0.0101...b.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_udiv3(alt_u32 n, alt_u32* rem)
+{
+	alt_u32 q, r;
+
+	q = (n >> 2) + (n >> 4);
+	q += q >> 4;
+	q += q >> 8;
+	q += q >> 16;
+	r = n - ((q << 1) + q);
+	// 11 * r / 32 is r / 3 for the remainders left
+	q += ((r << 3) + (r << 1) + r) >> 5;
+	*rem = n - ((q << 1) + q);
+	return q;
+}
+
+/**
+ * @brief \em n / 5, q = n * 0.8 / 4.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_udiv5(alt_u32 n, alt_u32* rem)
+{
+	alt_u32 q, r;
+
+	q = (n >> 1) + (n >> 2);
+	q += q >> 4;
+	q += q >> 8;
+	q += q >> 16;
+	q >>= 2;
+	r = n - ((q << 2) + q);
+	// 7 * r / 32 is r / 5 for the remainders left
+	q += ((r << 3) - r) >> 5;
+	*rem = n - ((q << 2) + q);
+	return q;
+}
+
+/**
+ * @brief \em n / 7, q = n * 0.1001...b / 4.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_udiv7(alt_u32 n, alt_u32* rem)
+{
+	alt_u32 q, r;
+
+	q = (n >> 1) + (n >> 4);
+	q += q >> 6;
+	q += (q >> 12) + (q >> 24);
+	q >>= 2;
+	r = n - ((q << 3) - q);
+	// (r + 1) / 8 is r / 7 for the remainders left
+	q += (r + 1) >> 3;
+	*rem = n - ((q << 3) - q);
+	return q;
+}
+
+/**
+ * @brief \em n / 10, q = n * 0.8 / 8.
+ *
+ * At most one short; the remainder then corrects it.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_udiv10(alt_u32 n, alt_u32* rem)
+{
+	alt_u32 q, r;
+
+	q = (n >> 1) + (n >> 2);
+	q += q >> 4;
+	q += q >> 8;
+	q += q >> 16;
+	q >>= 3;
+	r = n - ((q << 3) + (q << 1));
+	if (r > 9)
+	{
+		q++;
+		r -= 10;
+	}
+	*rem = r;
+	return q;
+}
+
+/*
+ * Divide an unsigned 32-bit value by the constant d (not 0). The choice
+ * of path folds away at compile time, also at -O0. Other divisors call
+ * the runtime.
+ */
+#define ALT_UDIVMOD_CONST(n, d, rem)                                  \
+	((((d) & ((d) - 1)) == 0) ?                                       \
+		(*(rem) = (alt_u32)(n) & ((d) - 1),                           \
+		 (alt_u32)(n) >> __builtin_ctz(d)) :                          \
+	((d) == 3) ? alt_udiv3((n), (rem)) :                              \
+	((d) == 5) ? alt_udiv5((n), (rem)) :                              \
+	((d) == 7) ? alt_udiv7((n), (rem)) :                              \
+	((d) == 10) ? alt_udiv10((n), (rem)) :                            \
+	alt_udivmod((n), (d), (rem)))
+
+#define ALT_UDIV_CONST(n, d) \
+	__extension__ ({ alt_u32 __alt_r; ALT_UDIVMOD_CONST((n), (d), &__alt_r); })
+
+#define ALT_UMOD_CONST(n, d) \
+	__extension__ ({ alt_u32 __alt_r; (void)ALT_UDIVMOD_CONST((n), (d), &__alt_r); __alt_r; })
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __ALT_MULDIV_H__ */
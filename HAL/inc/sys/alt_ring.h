@@ -0,0 +1,215 @@
+// #################################################################################################
+// # << RIDECORE: alt_ring.h - Lock-free SPSC Byte Ring >>                                       #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+/**********************************************************************//**
+ * @file alt_ring.h
+ * @author ncik20
+ * @brief Single-producer/single-consumer byte ring buffer.
+ *
+ * The producer (an interrupt handler) only writes #alt_ring.head, the
+ * consumer only writes #alt_ring.tail. Both indices run freely and are
+ * masked on access, so publishing data or freeing space is a single word
+ * store and neither side needs to mask interrupts. The storage size is a
+ * power of two chosen at compile time with ALT_RING_INSTANCE().
+ * ALT_RING_STAMPED_INSTANCE() adds a parallel array in which the
+ * producer stores the mcycle value at which each byte was received.
+ *
+ * @note The field offsets are used by the assembly producer in interrupt.S.
+ **************************************************************************/
+
+#ifndef __ALT_RING_H__
+#define __ALT_RING_H__
+
+/*
+ * Field offsets for assembly code
+ */
+#define ALT_RING_HEAD      0
+#define ALT_RING_TAIL      4
+#define ALT_RING_MASK      8
+#define ALT_RING_OVERFLOW  12
+#define ALT_RING_BUF       16
+#define ALT_RING_STAMP     20
+
+#ifndef ALT_ASM_SRC
+
+#include <stddef.h>
+#include "../alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * Keep the compiler from moving buffer accesses across index accesses.
+ * A single hart sees its own (and its interrupt handlers') accesses in
+ * program order, so no fence instruction is needed.
+ */
+#define ALT_RING_BARRIER() asm volatile ("" : : : "memory")
+
+typedef struct alt_ring
+{
+	/// @brief write index, owned by the producer
+	volatile alt_u32 head;
+	/// @brief read index, owned by the consumer
+	volatile alt_u32 tail;
+	/// @brief storage size - 1
+	alt_u32 mask;
+	/// @brief bytes dropped because the ring was full, owned by the producer
+	volatile alt_u32 overflow;
+	/// @brief storage
+	alt_u8* buf;
+	/// @brief receive time (mcycle) of each byte in \c buf, NULL if not recorded
+	alt_u32* stamp;
+} alt_ring;
+
+/*
+ * Ring storage goes to its own region (.ring in stdld.script), which
+ * crt0 does not clear: the indices alone say what is valid.
+ */
+#ifndef ALT_RING_SECTION
+#define ALT_RING_SECTION __attribute__((section(".ring")))
+#endif
+
+/*
+ * Allocate a ring and its storage. \em size must be a power of two.
+ */
+#define ALT_RING_INSTANCE(name, size)										\
+  typedef char name##_size_is_not_a_power_of_two[((size) & ((size) - 1)) ? -1 : 1];	\
+  static alt_u8 name##_storage[size] ALT_RING_SECTION;							\
+  alt_ring name =															\
+  {																			\
+	0,																		\
+	0,																		\
+	(size) - 1,																\
+	0,																		\
+	name##_storage,															\
+	NULL																	\
+  }
+
+/*
+ * Allocate a ring that also records the receive time of every byte.
+ */
+#define ALT_RING_STAMPED_INSTANCE(name, size)								\
+  typedef char name##_size_is_not_a_power_of_two[((size) & ((size) - 1)) ? -1 : 1];	\
+  static alt_u8 name##_storage[size] ALT_RING_SECTION;							\
+  static alt_u32 name##_stamps[size] ALT_RING_SECTION;							\
+  alt_ring name =															\
+  {																			\
+	0,																		\
+	0,																		\
+	(size) - 1,																\
+	0,																		\
+	name##_storage,															\
+	name##_stamps															\
+  }
+
+/**
+ * @brief Number of bytes waiting in the ring.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_ring_count(const alt_ring* ring)
+{
+  return ring->head - ring->tail;
+}
+
+/**
+ * @brief Producer side: append one byte.
+ *
+ * @return 0 on success, -1 if the ring is full (the byte is counted in \c overflow).
+ **/
+static ALT_INLINE int ALT_ALWAYS_INLINE alt_ring_put(alt_ring* ring, alt_u8 byte)
+{
+  alt_u32 head = ring->head;
+
+  if (head - ring->tail > ring->mask)
+  {
+    ring->overflow++;
+    return -1;
+  }
+  ring->buf[head & ring->mask] = byte;
+  ALT_RING_BARRIER();
+  ring->head = head + 1;
+  return 0;
+}
+
+/**
+ * @brief Consumer side: look at the waiting bytes without removing them.
+ *
+ * @param ring -- the ring.
+ * @param data -- set to the first waiting byte.
+ *
+ * @return the number of bytes readable at \em data. Bytes that wrap
+ * around the end of the storage are returned by the next call, after
+ * alt_ring_consume().
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_ring_peek(alt_ring* ring, alt_u8** data)
+{
+  alt_u32 tail = ring->tail;
+  alt_u32 count = ring->head - tail;
+  alt_u32 offset = tail & ring->mask;
+  alt_u32 contiguous = ring->mask + 1 - offset;
+
+  ALT_RING_BARRIER();
+  *data = ring->buf + offset;
+  return (count < contiguous) ? count : contiguous;
+}
+
+/**
+ * @brief Consumer side: receive times of the bytes returned by
+ * alt_ring_peek(), NULL if the ring does not record them.
+ **/
+static ALT_INLINE alt_u32* ALT_ALWAYS_INLINE alt_ring_peek_stamps(const alt_ring* ring)
+{
+  if (ring->stamp == NULL)
+    return NULL;
+  return ring->stamp + (ring->tail & ring->mask);
+}
+
+/**
+ * @brief Consumer side: release \em count bytes returned by alt_ring_peek().
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE alt_ring_consume(alt_ring* ring, alt_u32 count)
+{
+  ALT_RING_BARRIER();
+  ring->tail += count;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif /* __ALT_RING_H__ */
@@ -0,0 +1,164 @@
+// #################################################################################################
+// # << RIDECORE: alt_sched.h - Run-To-Completion Scheduler >>                                   #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_sched.h
+ * @author ncik20
+ * @brief Cooperative run-to-completion scheduler with a bitmap ready set.
+ *
+ * Task n is ready while bit n of #alt_sched_ready is set. Interrupt
+ * handlers, timer callbacks and tasks post events by setting bits; the
+ * scheduler runs the ready task with the highest number, which picks the
+ * most significant set bit, and clears its bit first so that an event
+ * posted while it runs makes it run again. A task runs until it returns.
+ *
+ * With nothing ready the CPU sleeps in WFI, so a task costs nothing
+ * until an event for it is posted.
+ *
+ * @note ps2_isr in interrupt.S posts to #alt_sched_ready directly.
+ **************************************************************************/
+
+#ifndef __ALT_SCHED_H__
+#define __ALT_SCHED_H__
+
+#include "../ridecore.h"
+
+/*
+ * Number of tasks, at most 32. Higher numbers run first.
+ */
+#ifndef ALT_SCHED_MAX_TASKS
+#define ALT_SCHED_MAX_TASKS 8
+#endif
+
+/*
+ * 1: sleep in WFI while no task is ready. 0: spin on the ready set, for
+ * comparing wake-up latencies.
+ */
+#ifndef ALT_SCHED_IDLE_SLEEP
+#define ALT_SCHED_IDLE_SLEEP 1
+#endif
+
+#ifndef ALT_ASM_SRC
+
+#include "alt_irq.h"
+#include "alt_hist.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * @brief Task handler, runs with interrupts enabled.
+ *
+ * @param context -- the context registered with the task.
+ **/
+typedef void (*alt_sched_func)(void* context);
+
+typedef struct alt_sched_task
+{
+	alt_sched_func func;
+	void* context;
+} alt_sched_task;
+
+typedef struct
+{
+	/// @brief tasks run
+	alt_u32 dispatches;
+	/// @brief times the CPU went to sleep with nothing ready
+	alt_u32 sleeps;
+	/// @brief runs of each task
+	alt_u32 runs[ALT_SCHED_MAX_TASKS];
+} alt_sched_stats;
+
+/*
+ * Ready set, bit n: task n has an event pending
+ */
+extern volatile alt_u32 alt_sched_ready;
+extern alt_sched_stats alt_sched_stat;
+
+/**
+ * @brief Register task \em id. Events posted before are kept.
+ *
+ * @return 0 on success, or \c -EINVAL if \em id is out of range.
+ **/
+int alt_sched_register(alt_u32 id, alt_sched_func func, void* context);
+
+/**
+ * @brief Make task \em id ready. Safe to call from interrupt handlers.
+ **/
+static ALT_INLINE void ALT_ALWAYS_INLINE alt_sched_post(alt_u32 id)
+{
+	alt_irq_context irq_context;
+
+	irq_context = alt_irq_disable_all();
+	alt_sched_ready |= 1 << id;
+	alt_irq_enable_all(irq_context);
+}
+
+/**
+ * @brief Number of the highest ready task in \em ready, which must not be 0.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_sched_pick(alt_u32 ready)
+{
+#if defined(__riscv_zbb) || defined(ALT_HOST)
+	return 31 - __builtin_clz(ready);
+#else
+	// no clz instruction: five shift-and-test steps
+	return alt_log2(ready);
+#endif
+}
+
+/**
+ * @brief Run ready tasks, forever. Called by main() after the tasks are
+ * registered and the interrupts enabled.
+ **/
+void alt_sched_run(void) __attribute__((noreturn));
+
+/**
+ * @brief Non-zero while the running task is the first one run after the
+ * CPU was idle.
+ **/
+int alt_sched_woken(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif /* __ALT_SCHED_H__ */
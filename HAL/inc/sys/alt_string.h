@@ -1,6 +1,8 @@
 #ifndef __ALT_STRING_H__
 #define __ALT_STRING_H__
 
+#include <stddef.h>
+
 #ifndef NULL
 #define NULL ((void*)0)
 #endif
@@ -10,26 +12,21 @@ extern "C"
 {
 #endif /* __cplusplus */
 
-char * strcpy(char * dest, const char * src)
-{
-    if ( dest == NULL || src == NULL) // 地址检查
-    {
-        return NULL;
-    }
-
-    if ( dest == src) // 相同地址检查
-    {
-        return dest;
-    }
-
-    char * str = dest;
-    while ( ( *str++ = *src++ ) != '\0' )  // 循环复制
-    {
-        ;
-    }
-
-    return dest;
-}
+/*
+ * libc-lite string and memory functions (HAL/src/alt_string.c).
+ *
+ * Word-aligned blocks are moved 32 bits at a time with unrolled loops,
+ * and NUL bytes are found a word at a time, so rv32i needs about a
+ * quarter of the loads and stores of a byte loop. The functions carry
+ * the standard names, so calls emitted by the compiler (struct copies,
+ * array initialisers) resolve to them as well.
+ */
+
+void*  memcpy(void* dest, const void* src, size_t n);
+void*  memmove(void* dest, const void* src, size_t n);
+void*  memset(void* dest, int c, size_t n);
+size_t strlen(const char* s);
+char*  strcpy(char* dest, const char* src);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,122 @@
+// #################################################################################################
+// # << RIDECORE: alt_time.h - Microsecond Timeouts >>                                           #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+
+
+/**********************************************************************//**
+ * @file alt_time.h
+ * @author ncik20
+ * @brief Microsecond timeouts against mcycle.
+ *
+ * A deadline is the mcycle value (low word) at which a timeout expires.
+ * Deadlines are compared by the sign of the difference, so they stay
+ * correct across the wrap of the counter as long as a timeout is shorter
+ * than half its period (42 s at 50 MHz).
+ *
+ * The conversion from microseconds shifts and adds: the core has no
+ * multiplier.
+ **************************************************************************/
+
+#ifndef __ALT_TIME_H__
+#define __ALT_TIME_H__
+
+#include "../ridecore.h"
+
+/*
+ * Core clock in Hz, mcycle counts at this rate
+ */
+#ifndef ALT_CPU_FREQ
+#ifdef ALT_HOST
+// the host cycle counter (host/mmio_mock.c) counts nanoseconds
+#define ALT_CPU_FREQ 1000000000
+#else
+#define ALT_CPU_FREQ 50000000
+#endif
+#endif
+
+#define ALT_CPU_CYCLES_PER_US (ALT_CPU_FREQ / 1000000)
+
+#ifndef ALT_ASM_SRC
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+typedef alt_u32 alt_deadline;
+
+/**
+ * @brief Convert microseconds to core cycles.
+ **/
+static ALT_INLINE alt_u32 ALT_ALWAYS_INLINE alt_us_to_cycles(alt_u32 us)
+{
+	alt_u32 cycles = 0;
+	alt_u32 m = ALT_CPU_CYCLES_PER_US;
+
+	while (m)
+	{
+		if (m & 1)
+			cycles += us;
+		us <<= 1;
+		m >>= 1;
+	}
+	return cycles;
+}
+
+/**
+ * @brief Deadline \em us microseconds from now.
+ **/
+static ALT_INLINE alt_deadline ALT_ALWAYS_INLINE alt_deadline_us(alt_u32 us)
+{
+	return ridecore_cpu_get_cycle() + alt_us_to_cycles(us);
+}
+
+/**
+ * @brief Non-zero once \em deadline has passed.
+ **/
+static ALT_INLINE int ALT_ALWAYS_INLINE alt_deadline_passed(alt_deadline deadline)
+{
+	return (alt_32)(ridecore_cpu_get_cycle() - deadline) >= 0;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif /* __ALT_TIME_H__ */
@@ -0,0 +1,177 @@
+// #################################################################################################
+// # << RIDECORE: alt_timer.h - Software Timer Wheel >>                                          #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_timer.h
+ * @author ncik20
+ * @brief Software timers on a hashed timer wheel, driven by the machine
+ * timer interrupt.
+ *
+ * Time advances in ticks of 2^ALT_TIMER_TICK_SHIFT microseconds. A timer
+ * due at tick t is kept in slot (t mod ALT_TIMER_WHEEL_SIZE), on a doubly
+ * linked list: arming and cancelling a timer are O(1), and a tick only
+ * visits the timers of one slot. Timers further away than one turn of the
+ * wheel stay in their slot and are skipped until their turn comes.
+ *
+ * The tick only runs while a timer is armed. With none armed, MTI is
+ * masked and the CPU sleeps until the next external interrupt.
+ *
+ * Callbacks run in the machine timer interrupt, with interrupts disabled.
+ **************************************************************************/
+
+#ifndef __ALT_TIMER_H__
+#define __ALT_TIMER_H__
+
+#include "../ridecore.h"
+
+/*
+ * Tick length: 2^ALT_TIMER_TICK_SHIFT us (1024 us)
+ */
+#ifndef ALT_TIMER_TICK_SHIFT
+#define ALT_TIMER_TICK_SHIFT 10
+#endif
+
+#define ALT_TIMER_TICK_US (1 << ALT_TIMER_TICK_SHIFT)
+
+/*
+ * Number of wheel slots, must be a power of two
+ */
+#ifndef ALT_TIMER_WHEEL_SIZE
+#define ALT_TIMER_WHEEL_SIZE 16
+#endif
+
+#ifndef ALT_ASM_SRC
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * @brief Timer callback, runs in interrupt context.
+ *
+ * @param context -- the context given to alt_timer_setup().
+ **/
+typedef void (*alt_timer_func)(void* context);
+
+typedef struct alt_timer
+{
+	struct alt_timer* next;
+	/// @brief the pointer that points to this timer, NULL if not armed
+	struct alt_timer** pprev;
+	/// @brief tick at which the timer fires
+	alt_u32 expires;
+	/// @brief re-arm interval in ticks, 0 for a one-shot timer
+	alt_u32 period;
+	alt_timer_func func;
+	void* context;
+} alt_timer;
+
+/*
+ * Static initializer of an unarmed timer
+ */
+#define ALT_TIMER_INIT(func, context) { NULL, NULL, 0, 0, (func), (context) }
+
+typedef struct
+{
+	/// @brief ticks processed
+	alt_u32 ticks;
+	/// @brief ticks processed late, more than one per interrupt
+	alt_u32 late;
+	/// @brief callbacks run
+	alt_u32 fired;
+	/// @brief timers armed now
+	alt_u32 armed;
+} alt_timer_stats;
+
+extern alt_timer_stats alt_timer_stat;
+
+/*
+ * Current tick, counts only while a timer is armed
+ */
+extern volatile alt_u32 alt_timer_now;
+
+/**
+ * @brief Reset the wheel and the machine timer. Timers armed before are
+ * forgotten.
+ **/
+void alt_timer_init(void);
+
+/**
+ * @brief Set the callback of an unarmed timer.
+ **/
+void alt_timer_setup(alt_timer* timer, alt_timer_func func, void* context);
+
+/**
+ * @brief Arm \em timer to fire in \em us microseconds, and then every
+ * \em period_us if not 0. An armed timer is moved. Safe to call from a
+ * timer callback or an interrupt handler.
+ *
+ * Both times are rounded up to whole ticks. The first tick comes at most
+ * one tick from now, so the timer may fire up to one tick early.
+ **/
+void alt_timer_arm(alt_timer* timer, alt_u32 us, alt_u32 period_us);
+
+/**
+ * @brief Disarm \em timer. Safe to call from a timer callback or an
+ * interrupt handler.
+ *
+ * @return 1 if the timer was armed, 0 if not.
+ **/
+int alt_timer_cancel(alt_timer* timer);
+
+/**
+ * @brief Non-zero while \em timer is armed.
+ **/
+static ALT_INLINE int ALT_ALWAYS_INLINE alt_timer_armed(const alt_timer* timer)
+{
+	return timer->pprev != NULL;
+}
+
+/**
+ * @brief Machine timer interrupt handler, called by the vector table
+ * entry in interrupt.S. Runs the timers of every tick that has elapsed.
+ **/
+void alt_timer_isr(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* ALT_ASM_SRC */
+
+#endif /* __ALT_TIMER_H__ */
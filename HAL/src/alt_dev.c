@@ -0,0 +1,146 @@
+// #################################################################################################
+// # << RIDECORE: alt_dev.c - Device Registry >>                                                 #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+
+
+/**********************************************************************//**
+ * @file alt_dev.c
+ * @author ncik20
+ * @brief Device registry and file descriptor dispatch.
+ **************************************************************************/
+
+#include <stddef.h>
+#include <errno.h>
+
+#include "../inc/sys/alt_dev.h"
+
+typedef char alt_max_dev_is_not_a_power_of_two[(ALT_MAX_DEV & (ALT_MAX_DEV - 1)) ? -1 : 1];
+
+alt_dev_table alt_dev_list;
+
+/*
+ * djb2 with xor, shifts and adds only: the core has no multiplier
+ */
+static alt_u32 alt_dev_hash(const char* name)
+{
+	alt_u32 hash = 5381;
+
+	while (*name)
+		hash = ((hash << 5) + hash) ^ (alt_u8)*name++;
+	return hash;
+}
+
+static int alt_dev_name_eq(const char* a, const char* b)
+{
+	while (*a && *a == *b)
+	{
+		a++;
+		b++;
+	}
+	return *a == *b;
+}
+
+int alt_dev_reg(alt_dev* dev)
+{
+	alt_u32 i, n;
+
+	if (alt_dev_list.count >= ALT_MAX_DEV)
+		return -ENOSPC;
+
+	i = alt_dev_hash(dev->name);
+	for (n = 0; n < ALT_MAX_DEV; n++, i++)
+	{
+		alt_dev** slot = &alt_dev_list.slot[i & (ALT_MAX_DEV - 1)];
+
+		if (*slot == NULL)
+		{
+			*slot = dev;
+			alt_dev_list.count++;
+			return 0;
+		}
+		if (alt_dev_name_eq((*slot)->name, dev->name))
+			return -EEXIST;
+	}
+	return -ENOSPC;
+}
+
+alt_dev* alt_find_dev(const char* name, alt_dev_table* list)
+{
+	alt_u32 i, n;
+	alt_dev* dev;
+
+	i = alt_dev_hash(name);
+	// devices are never removed, so an empty slot ends the probe
+	for (n = 0; n < ALT_MAX_DEV; n++, i++)
+	{
+		dev = list->slot[i & (ALT_MAX_DEV - 1)];
+		if (dev == NULL)
+			return NULL;
+		if (alt_dev_name_eq(dev->name, name))
+			return dev;
+	}
+	return NULL;
+}
+
+int alt_fd_open(alt_fd* fd, const char* name, int flags)
+{
+	alt_dev* dev = alt_find_dev(name, &alt_dev_list);
+
+	if (dev == NULL)
+		return -ENODEV;
+
+	fd->dev = dev;
+	fd->priv = NULL;
+	fd->fd_flags = flags;
+	if (dev->open != NULL)
+		return dev->open(fd, name, flags, 0);
+	return 0;
+}
+
+int alt_read(alt_fd* fd, char* ptr, int len)
+{
+	if (fd->dev == NULL || fd->dev->read == NULL)
+		return -EBADF;
+	return fd->dev->read(fd, ptr, len);
+}
+
+int alt_write(alt_fd* fd, const char* ptr, int len)
+{
+	if (fd->dev == NULL || fd->dev->write == NULL)
+		return -EBADF;
+	return fd->dev->write(fd, ptr, len);
+}
@@ -0,0 +1,168 @@
+// #################################################################################################
+// # << RIDECORE: alt_format.c - Integer Formatting >>                                           #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_format.c
+ * @author ncik20
+ * @brief Division-free integer formatting, see alt_format.h.
+ *
+ * Digits are produced least significant first into the end of a local
+ * buffer, then copied out behind the padding.
+ **************************************************************************/
+
+#include "../inc/sys/alt_format.h"
+
+static const char hex_digits[16] = "0123456789abcdef";
+
+/*
+ * n / 10 for a u64, with the remainder in *rem. Same reciprocal as
+ * alt_udiv10() with one more doubling step; every shift is by a
+ * constant, so no shift helper from libgcc is needed either.
+ */
+static alt_u64 udiv10_64(alt_u64 n, alt_u32* rem)
+{
+	alt_u64 q;
+	alt_u32 r;
+
+	q = (n >> 1) + (n >> 2);
+	q += q >> 4;
+	q += q >> 8;
+	q += q >> 16;
+	q += q >> 32;
+	q >>= 3;
+	r = (alt_u32)(n - ((q << 3) + (q << 1)));
+	if (r > 9)
+	{
+		q++;
+		r -= 10;
+	}
+	*rem = r;
+	return q;
+}
+
+static alt_u32 fmt_out(char* buf, const char* digits, alt_u32 len, alt_u32 width, char pad)
+{
+	char* p = buf;
+
+	while (width > len)
+	{
+		*p++ = pad;
+		width--;
+	}
+	while (len--)
+		*p++ = *digits++;
+	*p = '\0';
+	return p - buf;
+}
+
+alt_u32 alt_fmt_u32_dec(char* buf, alt_u32 value, alt_u32 width, char pad)
+{
+	char tmp[ALT_FMT_U32_DEC_MAX];
+	char* p = tmp + ALT_FMT_U32_DEC_MAX;
+	alt_u32 r;
+
+	do
+	{
+		value = alt_udiv10(value, &r);
+		*--p = (char)('0' + r);
+	} while (value != 0);
+
+	return fmt_out(buf, p, tmp + ALT_FMT_U32_DEC_MAX - p, width, pad);
+}
+
+alt_u32 alt_fmt_u64_dec(char* buf, alt_u64 value, alt_u32 width, char pad)
+{
+	char tmp[ALT_FMT_U64_DEC_MAX];
+	char* p = tmp + ALT_FMT_U64_DEC_MAX;
+	alt_u32 low, r;
+
+	// 64-bit steps only while the high word is in use
+	while (value >> 32)
+	{
+		value = udiv10_64(value, &r);
+		*--p = (char)('0' + r);
+	}
+	low = (alt_u32)value;
+	do
+	{
+		low = alt_udiv10(low, &r);
+		*--p = (char)('0' + r);
+	} while (low != 0);
+
+	return fmt_out(buf, p, tmp + ALT_FMT_U64_DEC_MAX - p, width, pad);
+}
+
+alt_u32 alt_fmt_u32_hex(char* buf, alt_u32 value, alt_u32 width, char pad)
+{
+	char tmp[ALT_FMT_U32_HEX_MAX];
+	char* p = tmp + ALT_FMT_U32_HEX_MAX;
+
+	do
+	{
+		*--p = hex_digits[value & 0xf];
+		value >>= 4;
+	} while (value != 0);
+
+	return fmt_out(buf, p, tmp + ALT_FMT_U32_HEX_MAX - p, width, pad);
+}
+
+alt_u32 alt_fmt_u64_hex(char* buf, alt_u64 value, alt_u32 width, char pad)
+{
+	char tmp[ALT_FMT_U64_HEX_MAX];
+	char* p = tmp + ALT_FMT_U64_HEX_MAX;
+	alt_u32 low = (alt_u32)value;
+	alt_u32 high = (alt_u32)(value >> 32);
+	int i;
+
+	if (high != 0)
+	{
+		// all 8 digits of the low word, then the high word's
+		for (i = 0; i < 8; i++)
+		{
+			*--p = hex_digits[low & 0xf];
+			low >>= 4;
+		}
+		low = high;
+	}
+	do
+	{
+		*--p = hex_digits[low & 0xf];
+		low >>= 4;
+	} while (low != 0);
+
+	return fmt_out(buf, p, tmp + ALT_FMT_U64_HEX_MAX - p, width, pad);
+}
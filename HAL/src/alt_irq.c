@@ -0,0 +1,93 @@
+// #################################################################################################
+// # << RIDECORE: alt_irq.c - Interrupt Dispatch HW Driver >>                                    #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+/**********************************************************************//**
+ * @file alt_irq.c
+ * @author ncik20
+ * @brief Interrupt handler registration.
+ **************************************************************************/
+
+#include <stddef.h>
+#include <errno.h>
+
+#include "../inc/sys/alt_irq.h"
+
+/*
+ * Handler table, read by the external interrupt entry in interrupt.S.
+ * Every entry starts out with the default handler, so the dispatcher
+ * never has to test for an empty slot.
+ */
+alt_irq_handler alt_irq[ALT_NIRQ] =
+{
+	[0 ... ALT_NIRQ - 1] = { alt_irq_default_isr, NULL }
+};
+
+// number of interrupts taken by unregistered sources
+alt_u32 alt_irq_unhandled = 0;
+
+// written by the external interrupt entry in interrupt.S
+volatile alt_u32 alt_irq_entry_cycle = 0;
+alt_u32 alt_irq_max_latency[PLIC_PRIORITY_MAX + 1];
+
+void alt_irq_init(void)
+{
+	// MODE = 1: vectored, interrupts jump to BASE + 4 * cause
+	asm volatile ("csrw mtvec, %[base]" : : [base] "r" ((alt_u32)alt_irq_vector_table | 0x1));
+}
+
+int alt_irq_register(alt_u32 id, void* context, alt_isr_func handler)
+{
+	alt_irq_context irq_context;
+
+	if (id >= ALT_NIRQ)
+		return -EINVAL;
+
+	if (handler == NULL)
+		handler = alt_irq_default_isr;
+
+	// the dispatcher must never see a handler with the wrong context
+	irq_context = alt_irq_disable_all();
+	alt_irq[id].context = context;
+	alt_irq[id].handler = handler;
+	alt_irq_enable_all(irq_context);
+
+	return 0;
+}
+
+void alt_irq_default_isr(void* context, alt_u32 id)
+{
+	alt_irq_unhandled++;
+	plic_disable(id);
+}
@@ -0,0 +1,158 @@
+// #################################################################################################
+// # << RIDECORE: alt_muldiv.c - Software Multiply/Divide >>                                     #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_muldiv.c
+ * @author ncik20
+ * @brief Software multiply/divide runtime, see alt_muldiv.h.
+ *
+ * Replaces libgcc's __mulsi3/__udivsi3/__umodsi3/__divsi3/__modsi3. The
+ * loops are written with shifts and adds only, so the compiler does not
+ * turn them back into calls to themselves.
+ **************************************************************************/
+
+#include "../inc/sys/alt_muldiv.h"
+#include "../inc/sys/alt_hist.h"
+
+alt_32 __mulsi3(alt_32 a, alt_32 b)
+{
+	alt_u32 x, m, r = 0;
+	alt_u32 abs_a = a < 0 ? -(alt_u32)a : (alt_u32)a;
+	alt_u32 abs_b = b < 0 ? -(alt_u32)b : (alt_u32)b;
+	int neg;
+
+	// loop over the factor with the smaller magnitude; a * -m is
+	// -(a * m) modulo 2^32, so a small negative factor is short too
+	if (abs_a < abs_b)
+	{
+		x = (alt_u32)b;
+		m = abs_a;
+		neg = a < 0;
+	}
+	else
+	{
+		x = (alt_u32)a;
+		m = abs_b;
+		neg = b < 0;
+	}
+
+	// two bits of m per iteration, done when no bits are left
+	while (m != 0)
+	{
+		if (m & 1)
+			r += x;
+		if (m & 2)
+			r += x << 1;
+		x <<= 2;
+		m >>= 2;
+	}
+	return neg ? -r : r;
+}
+
+alt_u32 alt_udivmod(alt_u32 n, alt_u32 d, alt_u32* rem)
+{
+	alt_u32 q = 0, bit;
+	alt_u32 shift;
+
+	*rem = n;
+	if (d == 0)
+		return 0xFFFFFFFF;
+	if (n < d)
+		return 0;
+
+	shift = alt_log2(d);
+	if ((d & (d - 1)) == 0)
+	{
+		*rem = n & (d - 1);
+		return n >> shift;
+	}
+
+	// align the top bit of d with the top bit of n: only the quotient
+	// bits below it can be set, one iteration each
+	shift = alt_log2(n) - shift;
+	d <<= shift;
+	bit = (alt_u32)1 << shift;
+	do
+	{
+		if (n >= d)
+		{
+			n -= d;
+			q |= bit;
+		}
+		d >>= 1;
+		bit >>= 1;
+	} while (bit != 0);
+
+	*rem = n;
+	return q;
+}
+
+alt_u32 __udivsi3(alt_u32 n, alt_u32 d)
+{
+	alt_u32 r;
+
+	return alt_udivmod(n, d, &r);
+}
+
+alt_u32 __umodsi3(alt_u32 n, alt_u32 d)
+{
+	alt_u32 r;
+
+	alt_udivmod(n, d, &r);
+	return r;
+}
+
+alt_32 __divsi3(alt_32 n, alt_32 d)
+{
+	alt_u32 q, r;
+
+	if (d == 0)
+		return -1;
+	// -2^31 / -1 wraps to -2^31, as on the M extension
+	q = alt_udivmod(n < 0 ? -(alt_u32)n : (alt_u32)n,
+	                d < 0 ? -(alt_u32)d : (alt_u32)d, &r);
+	return (n ^ d) < 0 ? (alt_32)-q : (alt_32)q;
+}
+
+alt_32 __modsi3(alt_32 n, alt_32 d)
+{
+	alt_u32 r;
+
+	alt_udivmod(n < 0 ? -(alt_u32)n : (alt_u32)n,
+	            d < 0 ? -(alt_u32)d : (alt_u32)d, &r);
+	return n < 0 ? (alt_32)-r : (alt_32)r;
+}
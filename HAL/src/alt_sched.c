@@ -0,0 +1,106 @@
+// #################################################################################################
+// # << RIDECORE: alt_sched.c - Run-To-Completion Scheduler >>                                   #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_sched.c
+ * @author ncik20
+ * @brief Run-to-completion scheduler, see alt_sched.h.
+ **************************************************************************/
+
+#include <stddef.h>
+#include <errno.h>
+
+#include "../inc/sys/alt_sched.h"
+
+volatile alt_u32 alt_sched_ready = 0;
+alt_sched_stats alt_sched_stat;
+
+static alt_sched_task tasks[ALT_SCHED_MAX_TASKS];
+static int woken = 0;
+
+int alt_sched_register(alt_u32 id, alt_sched_func func, void* context)
+{
+	alt_irq_context irq_context;
+
+	if (id >= ALT_SCHED_MAX_TASKS || func == NULL)
+		return -EINVAL;
+
+	irq_context = alt_irq_disable_all();
+	tasks[id].func = func;
+	tasks[id].context = context;
+	alt_irq_enable_all(irq_context);
+	return 0;
+}
+
+int alt_sched_woken(void)
+{
+	return woken;
+}
+
+void alt_sched_run(void)
+{
+	alt_irq_context irq_context;
+	alt_u32 ready, id;
+
+	while (1)
+	{
+		irq_context = alt_irq_disable_all();
+		ready = alt_sched_ready;
+		if (ready == 0)
+		{
+#if ALT_SCHED_IDLE_SLEEP
+			// an event posted after the check leaves its interrupt
+			// pending, so WFI returns at once and the interrupt is
+			// taken when the mask is lifted
+			alt_sched_stat.sleeps++;
+			ridecore_cpu_sleep();
+#endif
+			alt_irq_enable_all(irq_context);
+			woken = 1;
+			continue;
+		}
+		id = alt_sched_pick(ready);
+		alt_sched_ready = ready & ~(1 << id);
+		alt_irq_enable_all(irq_context);
+
+		alt_sched_stat.dispatches++;
+		alt_sched_stat.runs[id]++;
+		if (tasks[id].func != NULL)
+			tasks[id].func(tasks[id].context);
+		woken = 0;
+	}
+}
@@ -0,0 +1,270 @@
+// #################################################################################################
+// # << RIDECORE: alt_string.c - libc-lite String Functions >>                                   #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+/**********************************************************************//**
+ * @file alt_string.c
+ * @author ncik20
+ * @brief Word-at-a-time memcpy/memmove/memset/strlen/strcpy for rv32i.
+ *
+ * rv32i has no unaligned or multi-word accesses, so the fast paths need
+ * both pointers at the same offset within a word: the head is copied
+ * bytewise up to the word boundary, the body 4 words per iteration, the
+ * tail bytewise again. Pointers with different offsets fall back to the
+ * byte loop.
+ **************************************************************************/
+
+#include "../inc/alt_types.h"
+#include "../inc/sys/alt_string.h"
+
+/*
+ * Word access to memory of any type. may_alias keeps -O2 from assuming
+ * these loads and stores cannot touch the caller's objects.
+ */
+typedef alt_u32 __attribute__ ((may_alias)) alt_word;
+
+#define WORD_MASK   (sizeof(alt_word) - 1)
+
+#define ALIGNED(p)  ((((alt_u32)(p)) & WORD_MASK) == 0)
+
+/*
+ * SWAR zero-byte test: non-zero iff one of the 4 bytes of w is 0x00.
+ */
+#define HAS_ZERO_BYTE(w)  (((w) - 0x01010101UL) & ~(w) & 0x80808080UL)
+
+void* memcpy(void* dest, const void* src, size_t n)
+{
+	alt_u8* d = (alt_u8*)dest;
+	const alt_u8* s = (const alt_u8*)src;
+
+	if ( ((((alt_u32)d) ^ ((alt_u32)s)) & WORD_MASK) == 0 )
+	{
+		// same offset within a word: align, then move words
+		while ( n > 0 && !ALIGNED(d) )
+		{
+			*d++ = *s++;
+			n--;
+		}
+
+		alt_word* dw = (alt_word*)d;
+		const alt_word* sw = (const alt_word*)s;
+
+		while ( n >= 16 )
+		{
+			alt_u32 w0 = sw[0];
+			alt_u32 w1 = sw[1];
+			alt_u32 w2 = sw[2];
+			alt_u32 w3 = sw[3];
+			dw[0] = w0;
+			dw[1] = w1;
+			dw[2] = w2;
+			dw[3] = w3;
+			dw += 4;
+			sw += 4;
+			n -= 16;
+		}
+		while ( n >= 4 )
+		{
+			*dw++ = *sw++;
+			n -= 4;
+		}
+
+		d = (alt_u8*)dw;
+		s = (const alt_u8*)sw;
+	}
+
+	while ( n > 0 )
+	{
+		*d++ = *s++;
+		n--;
+	}
+
+	return dest;
+}
+
+void* memmove(void* dest, const void* src, size_t n)
+{
+	alt_u8* d = (alt_u8*)dest;
+	const alt_u8* s = (const alt_u8*)src;
+
+	if ( d <= s || d >= s + n )
+		// a forward copy never overwrites unread source bytes
+		return memcpy(dest, src, n);
+
+	// overlapping with dest above src: copy backwards
+	d += n;
+	s += n;
+
+	if ( ((((alt_u32)d) ^ ((alt_u32)s)) & WORD_MASK) == 0 )
+	{
+		while ( n > 0 && !ALIGNED(d) )
+		{
+			*--d = *--s;
+			n--;
+		}
+
+		alt_word* dw = (alt_word*)d;
+		const alt_word* sw = (const alt_word*)s;
+
+		while ( n >= 16 )
+		{
+			alt_u32 w3 = sw[-1];
+			alt_u32 w2 = sw[-2];
+			alt_u32 w1 = sw[-3];
+			alt_u32 w0 = sw[-4];
+			dw[-1] = w3;
+			dw[-2] = w2;
+			dw[-3] = w1;
+			dw[-4] = w0;
+			dw -= 4;
+			sw -= 4;
+			n -= 16;
+		}
+		while ( n >= 4 )
+		{
+			*--dw = *--sw;
+			n -= 4;
+		}
+
+		d = (alt_u8*)dw;
+		s = (const alt_u8*)sw;
+	}
+
+	while ( n > 0 )
+	{
+		*--d = *--s;
+		n--;
+	}
+
+	return dest;
+}
+
+void* memset(void* dest, int c, size_t n)
+{
+	alt_u8* d = (alt_u8*)dest;
+	alt_u32 w = (alt_u8)c;
+
+	while ( n > 0 && !ALIGNED(d) )
+	{
+		*d++ = (alt_u8)c;
+		n--;
+	}
+
+	// replicate the byte without a multiply (no M extension)
+	w |= w << 8;
+	w |= w << 16;
+
+	alt_word* dw = (alt_word*)d;
+
+	while ( n >= 16 )
+	{
+		dw[0] = w;
+		dw[1] = w;
+		dw[2] = w;
+		dw[3] = w;
+		dw += 4;
+		n -= 16;
+	}
+	while ( n >= 4 )
+	{
+		*dw++ = w;
+		n -= 4;
+	}
+
+	d = (alt_u8*)dw;
+	while ( n > 0 )
+	{
+		*d++ = (alt_u8)c;
+		n--;
+	}
+
+	return dest;
+}
+
+size_t strlen(const char* s)
+{
+	const char* p = s;
+
+	while ( !ALIGNED(p) )
+	{
+		if ( *p == '\0' )
+			return p - s;
+		p++;
+	}
+
+	// an aligned word load never crosses into the next memory region
+	const alt_word* pw = (const alt_word*)p;
+	while ( !HAS_ZERO_BYTE(*pw) )
+		pw++;
+
+	p = (const char*)pw;
+	while ( *p != '\0' )
+		p++;
+
+	return p - s;
+}
+
+char* strcpy(char* dest, const char* src)
+{
+	char* d = dest;
+	const char* s = src;
+
+	if ( ((((alt_u32)d) ^ ((alt_u32)s)) & WORD_MASK) == 0 )
+	{
+		while ( !ALIGNED(s) )
+		{
+			if ( (*d++ = *s++) == '\0' )
+				return dest;
+		}
+
+		alt_word* dw = (alt_word*)d;
+		const alt_word* sw = (const alt_word*)s;
+		alt_u32 w = *sw;
+
+		// copy whole words until the one holding the terminator
+		while ( !HAS_ZERO_BYTE(w) )
+		{
+			*dw++ = w;
+			w = *++sw;
+		}
+
+		d = (char*)dw;
+		s = (const char*)sw;
+	}
+
+	while ( (*d++ = *s++) != '\0' )
+		;
+
+	return dest;
+}
@@ -0,0 +1,221 @@
+// #################################################################################################
+// # << RIDECORE: alt_timer.c - Software Timer Wheel >>                                          #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file alt_timer.c
+ * @author ncik20
+ * @brief Hashed timer wheel, see alt_timer.h.
+ **************************************************************************/
+
+#include <stddef.h>
+
+#include "../inc/clint.h"
+#include "../inc/sys/alt_irq.h"
+#include "../inc/sys/alt_time.h"
+#include "../inc/sys/alt_timer.h"
+
+typedef char alt_timer_wheel_size_is_not_a_power_of_two[
+	(ALT_TIMER_WHEEL_SIZE & (ALT_TIMER_WHEEL_SIZE - 1)) ? -1 : 1];
+
+alt_timer_stats alt_timer_stat;
+volatile alt_u32 alt_timer_now = 0;
+
+static alt_timer* wheel[ALT_TIMER_WHEEL_SIZE];
+// mtime at which the next tick is due
+static alt_u64 tick_due;
+static alt_u32 tick_cycles;
+static int ticking = 0;
+
+static void wheel_insert(alt_timer* timer)
+{
+	alt_timer** slot = &wheel[timer->expires & (ALT_TIMER_WHEEL_SIZE - 1)];
+
+	timer->next = *slot;
+	if (*slot != NULL)
+		(*slot)->pprev = &timer->next;
+	*slot = timer;
+	timer->pprev = slot;
+}
+
+static void wheel_remove(alt_timer* timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next != NULL)
+		timer->next->pprev = timer->pprev;
+	timer->pprev = NULL;
+}
+
+static alt_u32 us_to_ticks(alt_u32 us)
+{
+	alt_u32 ticks = us >> ALT_TIMER_TICK_SHIFT;
+
+	if (us & (ALT_TIMER_TICK_US - 1))
+		ticks++;
+	return ticks ? ticks : 1;
+}
+
+static void tick_start(void)
+{
+	tick_due = clint_get_time() + tick_cycles;
+	clint_set_timecmp(tick_due);
+	clint_enable_irq();
+	ticking = 1;
+}
+
+static void tick_stop(void)
+{
+	clint_disable_irq();
+	clint_set_timecmp(~(alt_u64)0);
+	ticking = 0;
+}
+
+// advance alt_timer_now and run the timers due at the new tick
+static void tick_run(void)
+{
+	alt_timer* pending;
+	alt_timer* timer;
+	alt_u32 now = ++alt_timer_now;
+	alt_timer** slot = &wheel[now & (ALT_TIMER_WHEEL_SIZE - 1)];
+
+	alt_timer_stat.ticks++;
+
+	// take the slot's list off the wheel: callbacks may then arm and
+	// cancel any timer, this one and the pending ones included
+	pending = *slot;
+	*slot = NULL;
+	if (pending != NULL)
+		pending->pprev = &pending;
+
+	while ((timer = pending) != NULL)
+	{
+		wheel_remove(timer);
+		if (timer->expires != now)
+		{
+			// due on a later turn of the wheel
+			wheel_insert(timer);
+			continue;
+		}
+		if (timer->period)
+		{
+			timer->expires = now + timer->period;
+			wheel_insert(timer);
+		}
+		else
+			alt_timer_stat.armed--;
+		alt_timer_stat.fired++;
+		timer->func(timer->context);
+	}
+}
+
+void alt_timer_init(void)
+{
+	alt_u32 i;
+
+	clint_init();
+	for (i = 0; i < ALT_TIMER_WHEEL_SIZE; i++)
+		wheel[i] = NULL;
+	tick_cycles = alt_us_to_cycles(ALT_TIMER_TICK_US);
+	ticking = 0;
+	alt_timer_stat.ticks = 0;
+	alt_timer_stat.late = 0;
+	alt_timer_stat.fired = 0;
+	alt_timer_stat.armed = 0;
+}
+
+void alt_timer_setup(alt_timer* timer, alt_timer_func func, void* context)
+{
+	timer->next = NULL;
+	timer->pprev = NULL;
+	timer->expires = 0;
+	timer->period = 0;
+	timer->func = func;
+	timer->context = context;
+}
+
+void alt_timer_arm(alt_timer* timer, alt_u32 us, alt_u32 period_us)
+{
+	alt_irq_context irq_context;
+
+	irq_context = alt_irq_disable_all();
+	if (timer->pprev != NULL)
+		wheel_remove(timer);
+	else
+		alt_timer_stat.armed++;
+	timer->expires = alt_timer_now + us_to_ticks(us);
+	timer->period = period_us ? us_to_ticks(period_us) : 0;
+	wheel_insert(timer);
+	if (!ticking)
+		tick_start();
+	alt_irq_enable_all(irq_context);
+}
+
+int alt_timer_cancel(alt_timer* timer)
+{
+	alt_irq_context irq_context;
+	int armed;
+
+	// the tick stops at the next interrupt if this was the last timer
+	irq_context = alt_irq_disable_all();
+	armed = timer->pprev != NULL;
+	if (armed)
+	{
+		wheel_remove(timer);
+		alt_timer_stat.armed--;
+	}
+	alt_irq_enable_all(irq_context);
+	return armed;
+}
+
+void alt_timer_isr(void)
+{
+	alt_u64 now = clint_get_time();
+	alt_u32 ticks = 0;
+
+	// catch up on ticks missed while interrupts were disabled
+	while (ticking && now >= tick_due)
+	{
+		tick_due += tick_cycles;
+		if (ticks++)
+			alt_timer_stat.late++;
+		tick_run();
+	}
+
+	if (alt_timer_stat.armed == 0)
+		tick_stop();
+	else
+		clint_set_timecmp(tick_due);
+}
@@ -0,0 +1,74 @@
+// #################################################################################################
+// # << RIDECORE: clint.c - Machine Timer HW Driver >>                                           #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file clint.c
+ * @author ncik20
+ * @brief Machine timer driver, see clint.h.
+ **************************************************************************/
+
+#include "../inc/clint.h"
+
+void clint_init(void)
+{
+	clint_disable_irq();
+	clint_set_timecmp(~(alt_u64)0);
+}
+
+alt_u64 clint_get_time(void)
+{
+	alt_u32 hi, lo, hi2;
+
+	// re-read if the low word wrapped between the two accesses
+	do
+	{
+		hi = IORD(CLINT_BASE, CLINT_REG_MTIME_HI);
+		lo = IORD(CLINT_BASE, CLINT_REG_MTIME_LO);
+		hi2 = IORD(CLINT_BASE, CLINT_REG_MTIME_HI);
+	} while (hi != hi2);
+
+	return ((alt_u64)hi << 32) | lo;
+}
+
+void clint_set_timecmp(alt_u64 timecmp)
+{
+	// no intermediate value may lie below both the old and the new one:
+	// raise the low word first, so a spurious MTI cannot fire
+	IOWR(CLINT_BASE, CLINT_REG_MTIMECMP_LO, 0xFFFFFFFF);
+	IOWR(CLINT_BASE, CLINT_REG_MTIMECMP_HI, (alt_u32)(timecmp >> 32));
+	IOWR(CLINT_BASE, CLINT_REG_MTIMECMP_LO, (alt_u32)timecmp);
+}
@@ -0,0 +1,122 @@
+// #################################################################################################
+// # << RIDECORE: plic.c - PLIC HW Driver >>                                                     #
+// # ********************************************************************************************* #
+// # BSD 3-Clause License                                                                          #
+// #                                                                                               #
+// # Copyright (c) 2025, Stephan Nolting. All rights reserved.                                     #
+// #                                                                                               #
+// # Redistribution and use in source and binary forms, with or without modification, are          #
+// # permitted provided that the following conditions are met:                                     #
+// #                                                                                               #
+// # 1. Redistributions of source code must retain the above copyright notice, this list of        #
+// #    conditions and the following disclaimer.                                                   #
+// #                                                                                               #
+// # 2. Redistributions in binary form must reproduce the above copyright notice, this list of     #
+// #    conditions and the following disclaimer in the documentation and/or other materials        #
+// #    provided with the distribution.                                                            #
+// #                                                                                               #
+// # 3. Neither the name of the copyright holder nor the names of its contributors may be used to  #
+// #    endorse or promote products derived from this software without specific prior written      #
+// #    permission.                                                                                #
+// #                                                                                               #
+// # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS   #
+// # OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF               #
+// # MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE    #
+// # COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,     #
+// # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE #
+// # GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED    #
+// # AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING     #
+// # NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED  #
+// # OF THE POSSIBILITY OF SUCH DAMAGE.                                                            #
+// # ********************************************************************************************* #
+// # The RIDECORE Processor - https://github.com/ncik20/ridecore                      (c) ncik20 #
+// #################################################################################################
+
+
+
+
+/**********************************************************************//**
+ * @file plic.c
+ * @author ncik20
+ * @brief PLIC driver, see plic.h.
+ **************************************************************************/
+
+#include "../inc/plic.h"
+#include "../inc/sys/alt_irq.h"
+
+plic_regs plic_shadow = { 0, 0, 0, 0 };
+
+void plic_init(void)
+{
+	alt_u32 id;
+	alt_u32 priority = 0;
+
+	for (id = 0; id < PLIC_NUM_SOURCES; id++)
+		priority |= PLIC_PRIORITY_DEFAULT << (id << 2);
+
+	plic_shadow.trigger = 0;
+	plic_shadow.priority = priority;
+	plic_shadow.enable = 0;
+	plic_shadow.threshold = 0;
+
+	IOWR(PLIC_BASE, PLIC_REG_ENABLE, 0);
+	IOWR(PLIC_BASE, PLIC_REG_TRIGGER, 0);
+	IOWR(PLIC_BASE, PLIC_REG_PRIORITY, priority);
+	IOWR(PLIC_BASE, PLIC_REG_THRESHOLD, 0);
+}
+
+/*
+ * The shadow update and the register write must not be split by an
+ * interrupt handler changing the same register.
+ */
+
+void plic_set_trigger(alt_u32 id, int edge)
+{
+	alt_irq_context irq_context = alt_irq_disable_all();
+
+	if (edge)
+		plic_shadow.trigger |= 1 << id;
+	else
+		plic_shadow.trigger &= ~(1 << id);
+	IOWR(PLIC_BASE, PLIC_REG_TRIGGER, plic_shadow.trigger);
+
+	alt_irq_enable_all(irq_context);
+}
+
+void plic_set_priority(alt_u32 id, alt_u32 priority)
+{
+	alt_u32 shift = id << 2;
+	alt_irq_context irq_context = alt_irq_disable_all();
+
+	plic_shadow.priority = (plic_shadow.priority & ~(PLIC_PRIORITY_MAX << shift)) |
+		((priority & PLIC_PRIORITY_MAX) << shift);
+	IOWR(PLIC_BASE, PLIC_REG_PRIORITY, plic_shadow.priority);
+
+	alt_irq_enable_all(irq_context);
+}
+
+void plic_enable(alt_u32 id)
+{
+	alt_irq_context irq_context = alt_irq_disable_all();
+
+	plic_shadow.enable |= 1 << id;
+	IOWR(PLIC_BASE, PLIC_REG_ENABLE, plic_shadow.enable);
+
+	alt_irq_enable_all(irq_context);
+}
+
+void plic_disable(alt_u32 id)
+{
+	alt_irq_context irq_context = alt_irq_disable_all();
+
+	plic_shadow.enable &= ~(1 << id);
+	IOWR(PLIC_BASE, PLIC_REG_ENABLE, plic_shadow.enable);
+
+	alt_irq_enable_all(irq_context);
+}
+
+void plic_set_threshold(alt_u32 threshold)
+{
+	plic_shadow.threshold = threshold;
+	IOWR(PLIC_BASE, PLIC_REG_THRESHOLD, threshold);
+}
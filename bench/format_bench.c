@@ -0,0 +1,204 @@
+/*
+ * format_bench -- on-target microbenchmark of HAL/src/alt_format.c
+ *
+ * Times the shift-and-add decimal conversions against the usual
+ * '% 10' / '/ 10' digit loop. The reference divides with the same
+ * bit-serial shift-subtract loop as libgcc's __udivsi3/__udivdi3 for
+ * rv32i (muldiv_bench times the in-tree runtime). Each result holds the
+ * best of BENCH_REPEAT runs and the number of strings that differed
+ * between the two; the program then stops on an ebreak so
+ * format_bench_results can be read with a debugger or the simulator.
+ *
+ * Build: make format_bench
+ */
+
+#include "../HAL/inc/ridecore.h"
+#include "../HAL/inc/sys/alt_format.h"
+
+#define BENCH_REPEAT  8
+
+static const alt_u64 bench_values[] =
+{
+	0, 7, 12345, 4294967295ULL, 1000000000000ULL, 18446744073709551615ULL
+};
+#define BENCH_VALUE_NUM  (sizeof(bench_values) / sizeof(bench_values[0]))
+
+typedef struct
+{
+	alt_u32 value_lo;
+	alt_u32 value_hi;
+	// '% 10' / '/ 10' loop, u32 (0 if the value needs 64 bits)
+	alt_u32 div32_cycles;
+	// alt_fmt_u32_dec
+	alt_u32 fmt32_cycles;
+	// '% 10' / '/ 10' loop, u64
+	alt_u32 div64_cycles;
+	// alt_fmt_u64_dec
+	alt_u32 fmt64_cycles;
+	// strings that differ from the reference
+	alt_u32 errors;
+} format_bench_result;
+
+format_bench_result format_bench_results[BENCH_VALUE_NUM];
+
+static char ref_buf[ALT_FMT_U64_DEC_MAX + 1];
+static char fmt_buf[ALT_FMT_U64_DEC_MAX + 1];
+
+////////////////////////////////////////////////////////////////////
+// Divide-based references
+
+// restoring division, one quotient bit per iteration
+__attribute__ ((noinline)) static alt_u32 ref_udivmod32(alt_u32 n, alt_u32 d, alt_u32* rem)
+{
+	alt_u32 q = 0, r = 0;
+	int i;
+
+	for (i = 31; i >= 0; i--)
+	{
+		r = (r << 1) | ((n >> i) & 1);
+		if (r >= d)
+		{
+			r -= d;
+			q |= (alt_u32)1 << i;
+		}
+	}
+	*rem = r;
+	return q;
+}
+
+__attribute__ ((noinline)) static alt_u64 ref_udivmod64(alt_u64 n, alt_u32 d, alt_u32* rem)
+{
+	alt_u64 q = 0;
+	alt_u32 r = 0;
+	int i;
+
+	for (i = 63; i >= 0; i--)
+	{
+		r = (r << 1) | (alt_u32)((n >> 63) & 1);
+		n <<= 1;
+		q <<= 1;
+		if (r >= d)
+		{
+			r -= d;
+			q |= 1;
+		}
+	}
+	*rem = r;
+	return q;
+}
+
+__attribute__ ((noinline)) static alt_u32 ref_fmt_u32_dec(char* buf, alt_u32 value)
+{
+	char tmp[ALT_FMT_U32_DEC_MAX];
+	alt_u32 len = 0, r;
+
+	do
+	{
+		value = ref_udivmod32(value, 10, &r);
+		tmp[len++] = (char)('0' + r);
+	} while (value != 0);
+
+	for (r = 0; r < len; r++)
+		buf[r] = tmp[len - 1 - r];
+	buf[len] = '\0';
+	return len;
+}
+
+__attribute__ ((noinline)) static alt_u32 ref_fmt_u64_dec(char* buf, alt_u64 value)
+{
+	char tmp[ALT_FMT_U64_DEC_MAX];
+	alt_u32 len = 0, r;
+
+	do
+	{
+		value = ref_udivmod64(value, 10, &r);
+		tmp[len++] = (char)('0' + r);
+	} while (value != 0);
+
+	for (r = 0; r < len; r++)
+		buf[r] = tmp[len - 1 - r];
+	buf[len] = '\0';
+	return len;
+}
+////////////////////////////////////////////////////////////////////
+
+enum
+{
+	BENCH_DIV32,
+	BENCH_FMT32,
+	BENCH_DIV64,
+	BENCH_FMT64
+};
+
+static alt_u32 run(int bench, alt_u64 value)
+{
+	alt_u32 best = 0xFFFFFFFF;
+	alt_u32 start, cycles;
+	int i;
+
+	for (i = 0; i < BENCH_REPEAT; i++)
+	{
+		start = ridecore_cpu_get_cycle();
+		switch (bench)
+		{
+			case BENCH_DIV32:
+				ref_fmt_u32_dec(ref_buf, (alt_u32)value);
+				break;
+			case BENCH_FMT32:
+				alt_fmt_u32_dec(fmt_buf, (alt_u32)value, 0, ' ');
+				break;
+			case BENCH_DIV64:
+				ref_fmt_u64_dec(ref_buf, value);
+				break;
+			default:
+				alt_fmt_u64_dec(fmt_buf, value, 0, ' ');
+				break;
+		}
+		cycles = ridecore_cpu_get_cycle() - start;
+		if (cycles < best)
+			best = cycles;
+	}
+	return best;
+}
+
+static alt_u32 differ(const char* a, const char* b)
+{
+	while (*a != '\0' && *a == *b)
+	{
+		a++;
+		b++;
+	}
+	return *a != *b;
+}
+
+int main()
+{
+	format_bench_result* res;
+	alt_u64 value;
+	unsigned v;
+
+	for (v = 0; v < BENCH_VALUE_NUM; v++)
+	{
+		value = bench_values[v];
+		res = &format_bench_results[v];
+		res->value_lo = (alt_u32)value;
+		res->value_hi = (alt_u32)(value >> 32);
+		res->errors = 0;
+
+		if (res->value_hi == 0)
+		{
+			res->div32_cycles = run(BENCH_DIV32, value);
+			res->fmt32_cycles = run(BENCH_FMT32, value);
+			res->errors += differ(ref_buf, fmt_buf);
+		}
+		res->div64_cycles = run(BENCH_DIV64, value);
+		res->fmt64_cycles = run(BENCH_FMT64, value);
+		res->errors += differ(ref_buf, fmt_buf);
+	}
+
+	ridecore_cpu_breakpoint();
+	while (1)
+		;
+
+	return 0;
+}
@@ -0,0 +1,224 @@
+/*
+ * muldiv_bench -- on-target microbenchmark of HAL/src/alt_muldiv.c
+ *
+ * Times '*', '/' and the constant-divisor macros for a table of operand
+ * pairs from small to full width. Each row holds three columns, the best
+ * of BENCH_REPEAT runs each:
+ *   ref_cycles    the libgcc algorithms for rv32i: a multiply loop over
+ *                 the bits of the second factor, a 32-step restoring
+ *                 division
+ *   rt_cycles     the same operation compiled to a runtime call
+ *                 (__mulsi3, __udivsi3, __divsi3 from alt_muldiv.c)
+ *   const_cycles  ALT_UDIV_CONST(), for the divisors it has a fast path
+ *                 for (0 otherwise)
+ * and the number of results that differ from the reference. The program
+ * then stops on an ebreak so muldiv_bench_results can be read with a
+ * debugger or the simulator.
+ *
+ * Build: make muldiv_bench
+ */
+
+#include "../HAL/inc/ridecore.h"
+#include "../HAL/inc/sys/alt_muldiv.h"
+
+#define BENCH_REPEAT  8
+
+enum
+{
+	BENCH_MUL,
+	BENCH_UDIV,
+	BENCH_DIV
+};
+
+typedef struct
+{
+	alt_u32 op;
+	alt_u32 a;
+	alt_u32 b;
+} bench_case;
+
+static const bench_case bench_cases[] =
+{
+	{ BENCH_MUL,  3,          7 },
+	{ BENCH_MUL,  100000,     1000 },
+	{ BENCH_MUL,  0x12345,    0x6789 },
+	{ BENCH_MUL,  123456789,  0xFFFFFFFF },    // * -1
+	{ BENCH_MUL,  0x7FFFFFFF, 0x7FFFFFFF },
+	{ BENCH_UDIV, 5,          100 },
+	{ BENCH_UDIV, 0xFFFFFFFF, 0x10000 },
+	{ BENCH_UDIV, 100000,     1000 },
+	{ BENCH_UDIV, 0xFFFFFFFF, 3 },
+	{ BENCH_UDIV, 0xFFFFFFFF, 7 },
+	{ BENCH_UDIV, 123456789,  10 },
+	{ BENCH_UDIV, 0xFFFFFFFF, 12345 },
+	{ BENCH_DIV,  -100000,    7 },
+	{ BENCH_DIV,  -2147483647, -3 }
+};
+#define BENCH_CASE_NUM  (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+typedef struct
+{
+	alt_u32 op;
+	alt_u32 a;
+	alt_u32 b;
+	alt_u32 ref_cycles;
+	alt_u32 rt_cycles;
+	alt_u32 const_cycles;
+	// results that differ from the reference
+	alt_u32 errors;
+} muldiv_bench_result;
+
+muldiv_bench_result muldiv_bench_results[BENCH_CASE_NUM];
+
+// operands and result, volatile so every run does the work
+static volatile alt_u32 bench_a, bench_b, bench_q;
+
+////////////////////////////////////////////////////////////////////
+// libgcc algorithms
+
+__attribute__ ((noinline)) static alt_u32 ref_mul(alt_u32 a, alt_u32 b)
+{
+	alt_u32 r = 0;
+
+	while (b != 0)
+	{
+		if (b & 1)
+			r += a;
+		a <<= 1;
+		b >>= 1;
+	}
+	return r;
+}
+
+__attribute__ ((noinline)) static alt_u32 ref_udiv(alt_u32 n, alt_u32 d)
+{
+	alt_u32 q = 0, r = 0;
+	int i;
+
+	for (i = 31; i >= 0; i--)
+	{
+		r = (r << 1) | ((n >> i) & 1);
+		if (r >= d)
+		{
+			r -= d;
+			q |= (alt_u32)1 << i;
+		}
+	}
+	return q;
+}
+
+__attribute__ ((noinline)) static alt_32 ref_div(alt_32 n, alt_32 d)
+{
+	alt_u32 q;
+
+	q = ref_udiv(n < 0 ? -(alt_u32)n : (alt_u32)n,
+	             d < 0 ? -(alt_u32)d : (alt_u32)d);
+	return (n ^ d) < 0 ? (alt_32)-q : (alt_32)q;
+}
+////////////////////////////////////////////////////////////////////
+
+enum
+{
+	BENCH_REF,
+	BENCH_RT,
+	BENCH_CONST
+};
+
+// ALT_UDIV_CONST() needs a constant divisor: one case per fast path
+static int const_divisor(alt_u32 d)
+{
+	return d == 3 || d == 7 || d == 10 || d == 0x10000;
+}
+
+static alt_u32 run_const(alt_u32 a, alt_u32 b)
+{
+	switch (b)
+	{
+		case 3:
+			return ALT_UDIV_CONST(a, 3);
+		case 7:
+			return ALT_UDIV_CONST(a, 7);
+		case 10:
+			return ALT_UDIV_CONST(a, 10);
+		default:
+			return ALT_UDIV_CONST(a, 0x10000);
+	}
+}
+
+static alt_u32 run(const bench_case* c, int how)
+{
+	alt_u32 best = 0xFFFFFFFF;
+	alt_u32 start, cycles;
+	int i;
+
+	bench_a = c->a;
+	bench_b = c->b;
+	for (i = 0; i < BENCH_REPEAT; i++)
+	{
+		start = ridecore_cpu_get_cycle();
+		switch (c->op * 3 + how)
+		{
+			case BENCH_MUL * 3 + BENCH_REF:
+				bench_q = ref_mul(bench_a, bench_b);
+				break;
+			case BENCH_MUL * 3 + BENCH_RT:
+				bench_q = bench_a * bench_b;
+				break;
+			case BENCH_UDIV * 3 + BENCH_REF:
+				bench_q = ref_udiv(bench_a, bench_b);
+				break;
+			case BENCH_UDIV * 3 + BENCH_RT:
+				bench_q = bench_a / bench_b;
+				break;
+			case BENCH_UDIV * 3 + BENCH_CONST:
+				bench_q = run_const(bench_a, bench_b);
+				break;
+			case BENCH_DIV * 3 + BENCH_REF:
+				bench_q = ref_div(bench_a, bench_b);
+				break;
+			default:
+				bench_q = (alt_32)bench_a / (alt_32)bench_b;
+				break;
+		}
+		cycles = ridecore_cpu_get_cycle() - start;
+		if (cycles < best)
+			best = cycles;
+	}
+	return best;
+}
+
+int main()
+{
+	const bench_case* c;
+	muldiv_bench_result* res;
+	alt_u32 ref;
+	unsigned i;
+
+	for (i = 0; i < BENCH_CASE_NUM; i++)
+	{
+		c = &bench_cases[i];
+		res = &muldiv_bench_results[i];
+		res->op = c->op;
+		res->a = c->a;
+		res->b = c->b;
+		res->errors = 0;
+
+		res->ref_cycles = run(c, BENCH_REF);
+		ref = bench_q;
+		res->rt_cycles = run(c, BENCH_RT);
+		res->errors += bench_q != ref;
+
+		res->const_cycles = 0;
+		if (c->op == BENCH_UDIV && const_divisor(c->b))
+		{
+			res->const_cycles = run(c, BENCH_CONST);
+			res->errors += bench_q != ref;
+		}
+	}
+
+	ridecore_cpu_breakpoint();
+	while (1)
+		;
+
+	return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * string_bench -- on-target microbenchmark of HAL/src/alt_string.c
+ *
+ * Times the word-at-a-time memcpy/memset/strlen/strcpy against the byte
+ * loops they replace (the old alt_string.h strcpy and its byte-wise
+ * equivalents) with mcycle, over word-aligned buffers of several sizes.
+ * The best of BENCH_REPEAT runs is stored in string_bench_results, then
+ * the program stops on an ebreak so the results can be read with a
+ * debugger or the simulator.
+ *
+ * Build: make string_bench
+ */
+
+#include "../HAL/inc/ridecore.h"
+#include "../HAL/inc/sys/alt_string.h"
+
+#define BENCH_REPEAT   8
+#define BENCH_MAX_LEN  512
+
+enum
+{
+	BENCH_MEMCPY,
+	BENCH_MEMSET,
+	BENCH_STRLEN,
+	BENCH_STRCPY,
+	BENCH_NUM
+};
+
+static const alt_u32 bench_lens[] = { 8, 32, 128, 512 };
+#define BENCH_LEN_NUM  (sizeof(bench_lens) / sizeof(bench_lens[0]))
+
+typedef struct
+{
+	alt_u32 len;
+	// byte loop
+	alt_u32 byte_cycles;
+	// alt_string.c
+	alt_u32 word_cycles;
+} string_bench_result;
+
+string_bench_result string_bench_results[BENCH_NUM][BENCH_LEN_NUM];
+
+static alt_u32 src_buf[BENCH_MAX_LEN / 4 + 1];
+static alt_u32 dst_buf[BENCH_MAX_LEN / 4 + 1];
+
+////////////////////////////////////////////////////////////////////
+// Byte loop references
+
+__attribute__ ((noinline)) static void* byte_memcpy(void* dest, const void* src, size_t n)
+{
+	char* d = dest;
+	const char* s = src;
+	while ( n-- )
+		*d++ = *s++;
+	return dest;
+}
+
+__attribute__ ((noinline)) static void* byte_memset(void* dest, int c, size_t n)
+{
+	char* d = dest;
+	while ( n-- )
+		*d++ = c;
+	return dest;
+}
+
+__attribute__ ((noinline)) static size_t byte_strlen(const char* s)
+{
+	const char* p = s;
+	while ( *p )
+		p++;
+	return p - s;
+}
+
+// the strcpy alt_string.h used to define
+__attribute__ ((noinline)) static char* byte_strcpy(char* dest, const char* src)
+{
+	if ( dest == NULL || src == NULL )
+		return NULL;
+	if ( dest == src )
+		return dest;
+	char* str = dest;
+	while ( ( *str++ = *src++ ) != '\0' )
+		;
+	return dest;
+}
+////////////////////////////////////////////////////////////////////
+
+static alt_u32 run(int bench, int word, alt_u32 len)
+{
+	char* src = (char*)src_buf;
+	char* dst = (char*)dst_buf;
+	alt_u32 best = 0xFFFFFFFF;
+	alt_u32 start, cycles;
+	int i;
+
+	for (i = 0; i < BENCH_REPEAT; i++)
+	{
+		start = ridecore_cpu_get_cycle();
+		switch (bench)
+		{
+			case BENCH_MEMCPY:
+				word ? memcpy(dst, src, len) : byte_memcpy(dst, src, len);
+				break;
+			case BENCH_MEMSET:
+				word ? memset(dst, 0x5A, len) : byte_memset(dst, 0x5A, len);
+				break;
+			case BENCH_STRLEN:
+				word ? strlen(src) : byte_strlen(src);
+				break;
+			default:
+				word ? strcpy(dst, src) : byte_strcpy(dst, src);
+				break;
+		}
+		cycles = ridecore_cpu_get_cycle() - start;
+		if (cycles < best)
+			best = cycles;
+	}
+	return best;
+}
+
+int main()
+{
+	int bench;
+	unsigned l;
+	alt_u32 len;
+
+	for (bench = 0; bench < BENCH_NUM; bench++)
+	{
+		for (l = 0; l < BENCH_LEN_NUM; l++)
+		{
+			len = bench_lens[l];
+
+			// string of len characters for strlen/strcpy
+			byte_memset(src_buf, 'a', len);
+			((char*)src_buf)[len] = '\0';
+
+			string_bench_results[bench][l].len = len;
+			string_bench_results[bench][l].byte_cycles = run(bench, 0, len);
+			string_bench_results[bench][l].word_cycles = run(bench, 1, len);
+		}
+	}
+
+	ridecore_cpu_breakpoint();
+	while (1)
+		;
+
+	return 0;
+}
@@ -0,0 +1,141 @@
+#include "console.h"
+#include "HAL/inc/sys/alt_string.h"
+
+typedef char console_cols_is_not_a_multiple_of_4[(CONSOLE_COLS & 3) ? -1 : 1];
+typedef char console_rows_do_not_fill_the_display[
+	(CONSOLE_ROWS * CONSOLE_COLS == DISPLAY_SIZE) ? 1 : -1];
+typedef char console_lines_is_not_a_power_of_two[
+	(CONSOLE_LINES & (CONSOLE_LINES - 1)) ? -1 : 1];
+typedef char console_lines_is_out_of_range[
+	(CONSOLE_LINES >= CONSOLE_ROWS && CONSOLE_LINES <= 32) ? 1 : -1];
+
+#define CONSOLE_ALL_ROWS ((alt_u32)(((alt_u64)1 << CONSOLE_ROWS) - 1))
+
+/*
+ * Lines are numbered freely and stored at (number mod CONSOLE_LINES).
+ * Screen row r shows line console_top + r, so scrolling moves
+ * console_top and blanks one line instead of copying the screen up.
+ * Empty cells hold 0, which the display shows as blank.
+ */
+static char console_buf[CONSOLE_LINES][CONSOLE_COLS];
+// bit (n mod CONSOLE_LINES): line n was ended by a wrap, not a newline
+static alt_u32 console_wrapped = 0;
+static alt_u32 console_top = 0;
+static alt_u32 console_line = 0;
+static alt_u32 console_col = 0;
+// bit r: screen row r changed since the last flush
+static alt_u32 console_dirty = 0;
+
+console_stats console_out_stats = { 0, 0 };
+
+static char* console_line_buf(alt_u32 line)
+{
+	return console_buf[line & (CONSOLE_LINES - 1)];
+}
+
+static alt_u32 console_line_bit(alt_u32 line)
+{
+	return (alt_u32)1 << (line & (CONSOLE_LINES - 1));
+}
+
+static void console_touch(void)
+{
+	console_dirty |= (alt_u32)1 << (console_line - console_top);
+}
+
+static void console_newline(int wrapped)
+{
+	if (wrapped)
+		console_wrapped |= console_line_bit(console_line);
+	else
+		console_wrapped &= ~console_line_bit(console_line);
+
+	console_line++;
+	console_col = 0;
+	if (console_line - console_top >= CONSOLE_ROWS)
+	{
+		// every row now shows the line below it
+		console_top++;
+		console_dirty = CONSOLE_ALL_ROWS;
+		console_out_stats.scrolls++;
+	}
+	memset(console_line_buf(console_line), 0, CONSOLE_COLS);
+	console_touch();
+}
+
+static void console_backspace(void)
+{
+	if (console_col == 0)
+	{
+		// back onto the line the cursor wrapped from, if it is on screen
+		if (console_line == console_top ||
+			!(console_wrapped & console_line_bit(console_line - 1)))
+			return;
+		console_line--;
+		console_col = CONSOLE_COLS;
+		console_wrapped &= ~console_line_bit(console_line);
+	}
+	console_line_buf(console_line)[--console_col] = 0;
+	console_touch();
+}
+
+void console_putc(char c)
+{
+	switch (c)
+	{
+		case '\n':
+			console_newline(0);
+			return;
+		case '\b':
+			console_backspace();
+			return;
+		case '\t':
+			do
+				console_putc(' ');
+			while (console_col & 3);
+			return;
+		default:
+			if (c < ' ' || c >= 0x7f)
+				return;
+			break;
+	}
+
+	// wrap when the next character comes, so a full line followed by
+	// '\n' does not leave an empty line
+	if (console_col == CONSOLE_COLS)
+		console_newline(1);
+	console_line_buf(console_line)[console_col++] = c;
+	console_touch();
+}
+
+void console_puts(const char* s)
+{
+	while (*s != 0)
+		console_putc(*s++);
+}
+
+void console_clear(void)
+{
+	memset(console_buf, 0, sizeof(console_buf));
+	console_wrapped = 0;
+	console_top = console_line;
+	console_col = 0;
+	console_dirty = CONSOLE_ALL_ROWS;
+}
+
+void console_flush(void)
+{
+	alt_u32 dirty = console_dirty;
+	alt_u32 row, offset;
+
+	console_dirty = 0;
+	for (row = 0, offset = 0; dirty != 0; row++, offset += CONSOLE_COLS, dirty >>= 1)
+	{
+		if (dirty & 1)
+		{
+			display_write(offset, console_line_buf(console_top + row), CONSOLE_COLS);
+			console_out_stats.redraws++;
+		}
+	}
+	display_flush();
+}
@@ -0,0 +1,70 @@
+#ifndef __CONSOLE_H__
+#define __CONSOLE_H__
+
+#include "HAL/inc/alt_types.h"
+#include "display.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * Text terminal on the display region: CONSOLE_ROWS rows of CONSOLE_COLS
+ * characters. CONSOLE_COLS must be a multiple of 4 that divides
+ * DISPLAY_SIZE, so every row starts on a display word.
+ */
+#ifndef CONSOLE_COLS
+#define CONSOLE_COLS 16
+#endif
+
+#define CONSOLE_ROWS (DISPLAY_SIZE / CONSOLE_COLS)
+
+/*
+ * Lines kept in the circular line buffer, a power of two of at least
+ * CONSOLE_ROWS and at most 32
+ */
+#ifndef CONSOLE_LINES
+#define CONSOLE_LINES 16
+#endif
+
+typedef struct
+{
+	/// @brief lines scrolled off the top
+	alt_u32 scrolls;
+	/// @brief rows passed to the display by console_flush()
+	alt_u32 redraws;
+} console_stats;
+
+extern console_stats console_out_stats;
+
+/**
+ * @brief Write \em c at the cursor. Printable characters wrap to the next
+ * line at the right edge, '\\n' starts a new line, '\\b' erases the
+ * character before the cursor (also across a wrap), '\\t' moves to the
+ * next multiple of 4 columns. Other control characters are ignored.
+ * Output reaches the display on the next console_flush().
+ **/
+void console_putc(char c);
+
+/**
+ * @brief console_putc() every character of the NUL terminated \em s.
+ **/
+void console_puts(const char* s);
+
+/**
+ * @brief Blank the screen and move the cursor to the top left.
+ **/
+void console_clear(void);
+
+/**
+ * @brief Copy the rows changed since the last flush to the display and
+ * flush it.
+ **/
+void console_flush(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CONSOLE_H__ */
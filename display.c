@@ -0,0 +1,88 @@
+#include "display.h"
+
+typedef char display_size_is_not_a_multiple_of_4[(DISPLAY_SIZE & 3) ? -1 : 1];
+
+/*
+ * The staging buffer mirrors the display region. Characters are written
+ * here, and each word touched since the last flush has its bit set in
+ * display_dirty; display_flush() then stores only those words. A word
+ * holding several new characters costs one store instead of one per byte.
+ */
+static alt_u32 display_shadow[DISPLAY_WORDS];
+static alt_u32 display_dirty[(DISPLAY_WORDS + 31) / 32];
+static alt_u32 display_cursor = 0;
+
+display_stats display_out_stats = { 0, 0, 0, 0, 0 };
+
+static void display_store(alt_u32 offset, char c)
+{
+	alt_u32 word = offset >> 2;
+
+	display_out_stats.chars++;
+	// the display already shows it, or will on the next flush
+	if (((char*)display_shadow)[offset] == c)
+	{
+		display_out_stats.unchanged++;
+		return;
+	}
+	((char*)display_shadow)[offset] = c;
+	display_dirty[word >> 5] |= (alt_u32)1 << (word & 31);
+}
+
+void display_putc(char c)
+{
+	if (display_cursor >= DISPLAY_SIZE)
+	{
+		// the words at the end must reach the display before they are
+		// overwritten from the start
+		display_flush();
+		display_cursor = 0;
+		display_out_stats.wraps++;
+	}
+	display_store(display_cursor++, c);
+}
+
+void display_puts(const char* s)
+{
+	while (*s != 0)
+		display_putc(*s++);
+}
+
+void display_write(alt_u32 offset, const char* s, alt_u32 len)
+{
+	while (len-- && offset < DISPLAY_SIZE)
+		display_store(offset++, *s++);
+}
+
+void display_seek(alt_u32 offset)
+{
+	display_cursor = (offset < DISPLAY_SIZE) ? offset : DISPLAY_SIZE;
+}
+
+void display_flush(void)
+{
+	volatile alt_u32* display = (volatile alt_u32*)DISPLAY_BASE;
+	alt_u32 i, word, bits;
+	alt_u32 stores = 0;
+
+	for (i = 0; i < sizeof(display_dirty) / sizeof(display_dirty[0]); i++)
+	{
+		bits = display_dirty[i];
+		display_dirty[i] = 0;
+
+		for (word = i << 5; bits != 0; word++, bits >>= 1)
+		{
+			if (bits & 1)
+			{
+				display[word] = display_shadow[word];
+				stores++;
+			}
+		}
+	}
+
+	if (stores)
+	{
+		display_out_stats.stores += stores;
+		display_out_stats.flushes++;
+	}
+}
@@ -0,0 +1,81 @@
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+#include "HAL/inc/alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * Character display region. Text output is bounded to
+ * [DISPLAY_BASE, DISPLAY_BASE + DISPLAY_SIZE) and wraps to the start;
+ * the default stops short of the count display at 0xa0.
+ * Both must be multiples of 4.
+ */
+#ifndef DISPLAY_BASE
+#define DISPLAY_BASE 0x00000000
+#endif
+#ifndef DISPLAY_SIZE
+#define DISPLAY_SIZE 0xa0
+#endif
+
+#define DISPLAY_WORDS (DISPLAY_SIZE / 4)
+
+/**
+ * @brief Output counters, chars / stores is the number of characters
+ * carried by each display store.
+ **/
+typedef struct
+{
+	/// @brief characters written to the staging buffer
+	alt_u32 chars;
+	/// @brief 32-bit stores to the display region
+	alt_u32 stores;
+	/// @brief display_flush() calls that stored at least one word
+	alt_u32 flushes;
+	/// @brief times the cursor wrapped to the start of the region
+	alt_u32 wraps;
+	/// @brief characters equal to the one already there, not stored
+	alt_u32 unchanged;
+} display_stats;
+
+extern display_stats display_out_stats;
+
+/**
+ * @brief Write a character at the cursor and advance it, wrapping at the
+ * end of the display region. Output reaches the display on the next
+ * display_flush().
+ **/
+void display_putc(char c);
+
+/**
+ * @brief display_putc() every character of the NUL terminated \em s.
+ **/
+void display_puts(const char* s);
+
+/**
+ * @brief Write \em len characters at byte \em offset of the display region
+ * without moving the cursor. Characters past the end of the region are
+ * dropped.
+ **/
+void display_write(alt_u32 offset, const char* s, alt_u32 len);
+
+/**
+ * @brief Move the cursor to byte \em offset of the display region.
+ **/
+void display_seek(alt_u32 offset);
+
+/**
+ * @brief Store every word changed since the last flush to the display,
+ * one aligned 32-bit store per word. Words rewritten with the characters
+ * they held are not stored.
+ **/
+void display_flush(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __DISPLAY_H__ */
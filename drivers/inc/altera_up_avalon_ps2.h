@@ -34,8 +34,35 @@
 #ifndef __ALTERA_UP_AVALON_PS2_H__
 #define __ALTERA_UP_AVALON_PS2_H__
 
+/*
+ * Command and reply bytes, also used by the receive handler in interrupt.S
+ */
+#define PS2_CMD_SET_LEDS		(0xED)
+#define PS2_CMD_SCAN_CODE_SET	(0xF0)
+#define PS2_CMD_TYPEMATIC		(0xF3)
+#define PS2_CMD_RESET			(0xFF)
+
+#define PS2_ACK					(0xFA)
+#define PS2_RESEND				(0xFE)
+#define PS2_BAT_PASS			(0xAA)
+#define PS2_BAT_FAIL			(0xFC)
+
+/*
+ * Replies the receive handler takes out of the data stream
+ * (alt_up_ps2_cmd_wait)
+ */
+// no command in flight, every byte is data
+#define ALT_UP_PS2_CMD_WAIT_NONE	0
+// PS2_ACK or PS2_RESEND for the byte just sent
+#define ALT_UP_PS2_CMD_WAIT_ACK		1
+// PS2_BAT_PASS or PS2_BAT_FAIL after a reset
+#define ALT_UP_PS2_CMD_WAIT_BAT		2
+
+#ifndef ALT_ASM_SRC
+
 #include <stddef.h>
 #include "../../HAL/inc/sys/alt_dev.h"
+#include "../../HAL/inc/sys/alt_ring.h"
 
 #include <errno.h>
 
@@ -66,12 +93,33 @@ typedef struct alt_up_ps2_dev {
 	unsigned int base;
 	/// @brief the interrupt id of the device.
 	unsigned int irq_id;
-	/// @brief the default timeout value.
+	/// @brief timeout of the blocking reads in microseconds, 0 for none.
 	unsigned int timeout;
 	/// @brief the device type (PS/2 Mouse or PS/2 Keyboard).
 	PS2_DEVICE device_type;
+	/// @brief detection step, see alt_up_ps2_init_step().
+	alt_u32 init_state;
+	/// @brief mcycle deadline of the detection step.
+	alt_u32 init_deadline;
+	/// @brief ring filled by the receive interrupt, NULL if none.
+	/// @sa alt_up_ps2_set_ring()
+	alt_ring* ring;
 } alt_up_ps2_dev;
 
+/*
+ * Default timeout of the blocking reads and of a command acknowledgment
+ */
+#define ALT_UP_PS2_TIMEOUT_US		20000
+/*
+ * A keyboard reports its self test (BAT) 500-750 ms after a reset
+ */
+#define ALT_UP_PS2_BAT_TIMEOUT_US	1000000
+/*
+ * A mouse sends its ID right after the BAT result, a keyboard sends
+ * nothing: silence for this long means a keyboard
+ */
+#define ALT_UP_PS2_ID_TIMEOUT_US	5000
+
 
 //////////////////////////////////////////////////////////////////////////
 // HAL system functions
@@ -84,10 +132,34 @@ typedef struct alt_up_ps2_dev {
  * @note The function will set the \c device_type field of \em ps2 to \c
  * PS2_MOUSE or \c PS2_KEYBOARD upon successful initialization, otherwise the
  * intialization is unsuccessful.
+ * @note Blocks until detection is done, at most about one second. See
+ * alt_up_ps2_init_start() for the non-blocking version.
  *
  **/
 void alt_up_ps2_init(alt_up_ps2_dev *ps2);
 
+/**
+ * @brief Start device detection: reset the device and return at once.
+ * Call alt_up_ps2_init_step() until it stops returning \c -EINPROGRESS.
+ *
+ * @param ps2 -- the PS/2 device structure.
+ *
+ * @note Detection polls the data register: keep the read interrupt
+ * disabled until it has finished.
+ **/
+void alt_up_ps2_init_start(alt_up_ps2_dev *ps2);
+
+/**
+ * @brief Advance device detection without waiting.
+ *
+ * @param ps2 -- the PS/2 device structure.
+ *
+ * @return \c -EINPROGRESS while detection runs, 0 once \c device_type is
+ * set, \c -EIO if the device failed its self test or could not be
+ * written, or \c -ETIMEDOUT if it did not answer.
+ **/
+int alt_up_ps2_init_step(alt_up_ps2_dev *ps2);
+
 /**
  * @brief Enable read interrupts for the PS/2 port.
  *
@@ -118,6 +190,8 @@ int alt_up_ps2_write_data_byte(alt_up_ps2_dev *ps2, unsigned char byte);
 
 /**
  * @brief Write a byte to the PS/2 port and wait for the acknowledgment.
+ * Bytes other than the acknowledgment received meanwhile are dropped:
+ * once the read interrupt is enabled, use the command engine instead.
  *
  * @param ps2 -- the PS/2 device structure.
  * @param byte -- the byte to be written to the PS/2 port.
@@ -150,6 +224,17 @@ int alt_up_ps2_read_data_byte(alt_up_ps2_dev *ps2, unsigned char *byte);
  **/
 int alt_up_ps2_read_data_byte_timeout(alt_up_ps2_dev *ps2, unsigned char *byte);
 
+/**
+ * @brief Tell the driver which ring the receive interrupt fills.
+ *
+ * @param ps2 -- the PS/2 device structure.
+ * @param ring -- the ring passed to the receive handler, NULL for none.
+ *
+ * @note With a ring, read() copies from it and write() goes through the
+ * command engine. Without one, both use the data register directly.
+ **/
+void alt_up_ps2_set_ring(alt_up_ps2_dev *ps2, alt_ring *ring);
+
 /**
  * @brief Clear the FIFO for the PS/2 port.
  *
@@ -161,14 +246,20 @@ void alt_up_ps2_clear_fifo(alt_up_ps2_dev *ps2);
 //////////////////////////////////////////////////////////////////////////
 // file-like operation functions
 /**
- * @brief Read \em len bytes from the PS/2 device.
+ * @brief Read up to \em len bytes from the PS/2 device.
  *
  * @param fd -- the file descriptor for the PS/2 device.
  * @param ptr -- memory location to store the bytes read.
  * @param len -- number of bytes to be read.
  *
- * @return the number of bytes actually read.
+ * @return the number of bytes actually read: everything available, in
+ * at most two copies out of the ring. If nothing is available, waits
+ * for the first byte, or returns \c -EWOULDBLOCK with \c ALT_O_NONBLOCK.
+ * Without a ring the wait is bounded by the device timeout and ends with
+ * \c -ETIMEDOUT.
  *
+ * @note Takes the bytes the main loop would otherwise see in the ring:
+ * use one or the other.
  **/
 int alt_up_ps2_read_fd (alt_fd* fd, char* ptr, int len);
 
@@ -179,7 +270,9 @@ int alt_up_ps2_read_fd (alt_fd* fd, char* ptr, int len);
  * @param ptr -- memory location storing the bytes to write.
  * @param len -- number of bytes to write.
  *
- * @return the number of bytes actually written.
+ * @return the number of bytes actually written (queued on the command
+ * engine if the device has a ring). With \c ALT_O_NONBLOCK, stops when
+ * the queue is full and returns \c -EWOULDBLOCK if nothing was queued.
  **/
 int alt_up_ps2_write_fd (alt_fd* fd, const char* ptr, int len);
 
@@ -196,6 +289,126 @@ int alt_up_ps2_write_fd (alt_fd* fd, const char* ptr, int len);
  **/
 alt_up_ps2_dev* alt_up_ps2_open_dev(const char* name);
 
+//////////////////////////////////////////////////////////////////////////
+// asynchronous command engine
+//
+// Commands are queued and sent one byte at a time. The receive handler
+// (ps2_isr in interrupt.S) takes the keyboard's replies out of the data
+// stream and passes them to alt_up_ps2_cmd_reply(), which sends the next
+// byte. Scan codes received meanwhile go to the receive ring as usual.
+// A byte left unanswered is sent again when a software timer
+// (alt_timer.h) expires. Needs the read interrupt and alt_timer_init().
+
+/*
+ * Number of queued commands, must be a power of two
+ */
+#ifndef ALT_UP_PS2_CMD_QUEUE_SIZE
+#define ALT_UP_PS2_CMD_QUEUE_SIZE 8
+#endif
+
+/*
+ * Sends of a byte answered with PS2_RESEND, or not answered within
+ * ALT_UP_PS2_TIMEOUT_US, before the command fails
+ */
+#define ALT_UP_PS2_CMD_TRIES 3
+
+/*
+ * LED bits of alt_up_ps2_cmd_set_leds()
+ */
+#define PS2_LED_SCROLL_LOCK	0x01
+#define PS2_LED_NUM_LOCK	0x02
+#define PS2_LED_CAPS_LOCK	0x04
+
+/**
+ * @brief Called by the command engine when a command has finished.
+ * Runs in interrupt context.
+ *
+ * @param cmd -- the command byte.
+ * @param status -- 0 on success, \c -EIO if it failed or was not acknowledged,
+ * \c -ETIMEDOUT if the keyboard did not reply.
+ **/
+typedef void (*alt_up_ps2_cmd_callback)(alt_u8 cmd, int status);
+
+typedef struct
+{
+	/// @brief commands queued
+	alt_u32 queued;
+	/// @brief commands completed successfully
+	alt_u32 done;
+	/// @brief commands that failed
+	alt_u32 failed;
+	/// @brief bytes written to the port, resends included
+	alt_u32 sent;
+	/// @brief PS2_RESEND replies
+	alt_u32 resends;
+	/// @brief replies not received in time
+	alt_u32 timeouts;
+	/// @brief replies that matched no byte in flight
+	alt_u32 stray;
+} alt_up_ps2_cmd_stats;
+
+// ALT_UP_PS2_CMD_WAIT_*, read by the receive handler
+extern volatile alt_u32 alt_up_ps2_cmd_wait;
+extern alt_up_ps2_cmd_stats alt_up_ps2_cmd_stat;
+
+/**
+ * @brief Queue a command of one or two bytes. The first byte is sent at
+ * once if the engine is idle.
+ *
+ * @param ps2 -- the PS/2 device structure.
+ * @param cmd -- the command byte.
+ * @param arg -- the argument byte, sent after the command is acknowledged.
+ * @param len -- 1 or 2, the number of bytes.
+ *
+ * @return 0 on success, \c -EAGAIN if the queue is full, or \c -EINVAL.
+ **/
+int alt_up_ps2_cmd_queue(alt_up_ps2_dev *ps2, alt_u8 cmd, alt_u8 arg, alt_u32 len);
+
+/**
+ * @brief Queue a reset. The command completes on the BAT result.
+ **/
+int alt_up_ps2_cmd_reset(alt_up_ps2_dev *ps2);
+
+/**
+ * @brief Queue a set LEDs command.
+ *
+ * @param leds -- combination of the PS2_LED_* bits.
+ **/
+int alt_up_ps2_cmd_set_leds(alt_up_ps2_dev *ps2, alt_u8 leds);
+
+/**
+ * @brief Queue a set typematic rate/delay command.
+ *
+ * @param rate_delay -- bits 6:5 delay (250ms steps from 250ms), bits 4:0
+ * repeat rate (0: 30/s ... 31: 2/s).
+ **/
+int alt_up_ps2_cmd_set_typematic(alt_up_ps2_dev *ps2, alt_u8 rate_delay);
+
+/**
+ * @brief Queue a scan code set selection.
+ *
+ * @param set -- 1, 2 or 3. The decoder in keyboard.c expects set 2.
+ **/
+int alt_up_ps2_cmd_set_scan_code_set(alt_up_ps2_dev *ps2, alt_u8 set);
+
+/**
+ * @brief Number of commands queued or in flight.
+ **/
+alt_u32 alt_up_ps2_cmd_pending(void);
+
+/**
+ * @brief Set the function called when a command finishes, NULL for none.
+ **/
+void alt_up_ps2_cmd_set_callback(alt_up_ps2_cmd_callback callback);
+
+/**
+ * @brief Advance the engine on a reply. Called by the receive handler
+ * with interrupts disabled.
+ *
+ * @param reply -- PS2_ACK, PS2_RESEND, PS2_BAT_PASS or PS2_BAT_FAIL.
+ **/
+void alt_up_ps2_cmd_reply(alt_u32 reply);
+
 /*
  * Macros used by alt_sys_init 
  */
@@ -215,8 +428,11 @@ alt_up_ps2_dev* alt_up_ps2_open_dev(const char* name);
     },                                              \
 	name##_BASE,                                	\
 	name##_IRQ,										\
-	0x0001ffff,										\
-	PS2_UNKNOWN										\
+	ALT_UP_PS2_TIMEOUT_US,							\
+	PS2_UNKNOWN,									\
+	0, /* init_state */								\
+	0, /* init_deadline */							\
+	NULL /* ring */									\
   }
 
 #define ALTERA_UP_AVALON_PS2_INIT(name, device)  \
@@ -232,6 +448,8 @@ alt_up_ps2_dev* alt_up_ps2_open_dev(const char* name);
 }
 #endif /* __cplusplus */
 
+#endif /* ALT_ASM_SRC */
+
 #endif /* __ALTERA_UP_AVALON_PS2_H__ */
 
 
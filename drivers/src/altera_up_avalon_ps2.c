@@ -37,8 +37,21 @@
 
 #include "../inc/altera_up_avalon_ps2.h"
 #include "../inc/altera_up_avalon_ps2_regs.h"
+#include "../../HAL/inc/sys/alt_irq.h"
+#include "../../HAL/inc/sys/alt_time.h"
+#include "../../HAL/inc/sys/alt_timer.h"
+#include "../../HAL/inc/sys/alt_string.h"
 
-#define PS2_ACK 	(0xFA)
+/*
+ * Device detection steps (alt_up_ps2_dev.init_state)
+ */
+#define PS2_INIT_IDLE		0
+// reset sent, waiting for PS2_ACK
+#define PS2_INIT_WAIT_ACK	1
+// waiting for the self test result
+#define PS2_INIT_WAIT_BAT	2
+// waiting for a mouse ID, silence means a keyboard
+#define PS2_INIT_WAIT_ID	3
 
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -83,30 +96,75 @@ alt_u8 read_data_byte(alt_u32 data_reg)
 // HAL Functions
 void alt_up_ps2_init(alt_up_ps2_dev *ps2)
 {
-	// initialize the device
+	alt_up_ps2_init_start(ps2);
+	while (alt_up_ps2_init_step(ps2) == -EINPROGRESS)
+		;
+}
+
+void alt_up_ps2_init_start(alt_up_ps2_dev *ps2)
+{
+	ps2->device_type = PS2_UNKNOWN;
+	//send the reset request, the ACK is collected by alt_up_ps2_init_step()
+	if (alt_up_ps2_write_data_byte(ps2, PS2_CMD_RESET) != 0)
+	{
+		ps2->init_state = PS2_INIT_IDLE;
+		ps2->init_deadline = 0;
+		return;
+	}
+	ps2->init_state = PS2_INIT_WAIT_ACK;
+	ps2->init_deadline = alt_deadline_us(ALT_UP_PS2_TIMEOUT_US);
+}
+
+int alt_up_ps2_init_step(alt_up_ps2_dev *ps2)
+{
 	unsigned char byte;
-	//send the reset request, wait for ACK
-	int status = alt_up_ps2_write_data_byte_with_ack(ps2, 0xff);
-	if (status == 0)
+
+	if (ps2->init_state == PS2_INIT_IDLE)
+		return (ps2->device_type != PS2_UNKNOWN) ? 0 : -EIO;
+
+	if (alt_up_ps2_read_data_byte(ps2, &byte) != 0)
 	{
-		// reset succeed, now try to get the BAT result, AA means passed
-		status = alt_up_ps2_read_data_byte_timeout(ps2, &byte);
-		if (status == 0 && byte == 0xAA)
+		if (!alt_deadline_passed(ps2->init_deadline))
+			return -EINPROGRESS;
+		if (ps2->init_state != PS2_INIT_WAIT_ID)
 		{
-			//get the 2nd byte
-			status = alt_up_ps2_read_data_byte_timeout(ps2, &byte);
-			if (status == -ETIMEDOUT)
+			ps2->init_state = PS2_INIT_IDLE;
+			return -ETIMEDOUT;
+		}
+		//for keyboard, only 2 bytes are sent(ACK, PASS/FAIL), so timeout
+		ps2->device_type = PS2_KEYBOARD;
+		ps2->init_state = PS2_INIT_IDLE;
+		return 0;
+	}
+
+	switch (ps2->init_state)
+	{
+		case PS2_INIT_WAIT_ACK:
+			// anything else is data that was in flight before the reset
+			if (byte == PS2_ACK)
 			{
-				//for keyboard, only 2 bytes are sent(ACK, PASS/FAIL), so timeout
-				ps2->device_type = PS2_KEYBOARD;
+				ps2->init_state = PS2_INIT_WAIT_BAT;
+				ps2->init_deadline = alt_deadline_us(ALT_UP_PS2_BAT_TIMEOUT_US);
 			}
-			else if (status == 0 && byte == 0x00)
+			return -EINPROGRESS;
+		case PS2_INIT_WAIT_BAT:
+			// reset succeed, AA means passed
+			if (byte != PS2_BAT_PASS)
 			{
-				//for mouse, it will sent out 0x00 after sending out ACK and PASS/FAIL.
-				ps2->device_type = PS2_MOUSE;
-				(void) alt_up_ps2_write_data_byte (ps2, 0xf4); // enable data from mouse
+				ps2->init_state = PS2_INIT_IDLE;
+				return -EIO;
 			}
-		}
+			ps2->init_state = PS2_INIT_WAIT_ID;
+			ps2->init_deadline = alt_deadline_us(ALT_UP_PS2_ID_TIMEOUT_US);
+			return -EINPROGRESS;
+		default:
+			ps2->init_state = PS2_INIT_IDLE;
+			if (byte != 0x00)
+				return -EIO;
+			//for mouse, it will sent out 0x00 after sending out ACK and PASS/FAIL.
+			ps2->device_type = PS2_MOUSE;
+			(void) alt_up_ps2_write_data_byte (ps2, 0xf4); // enable data from mouse
+			return 0;
 	}
 }
 
@@ -177,9 +235,8 @@ int alt_up_ps2_write_data_byte_with_ack(alt_up_ps2_dev *ps2, unsigned char byte)
 int alt_up_ps2_read_data_byte_timeout(alt_up_ps2_dev *ps2, unsigned char *byte)
 {
 	unsigned int data_reg = 0; 
-	unsigned int count = 0;
+	alt_deadline deadline = alt_deadline_us(ps2->timeout);
 	do {
-		count++;
 		data_reg = IORD_ALT_UP_PS2_PORT_DATA_REG(ps2->base);
 		if (read_data_valid(data_reg))
 		{
@@ -187,7 +244,7 @@ int alt_up_ps2_read_data_byte_timeout(alt_up_ps2_dev *ps2, unsigned char *byte)
 			return 0;
 		}
 		//timeout = 0 means to disable the timeout
-		if ( ps2->timeout != 0 && count > ps2->timeout)
+		if ( ps2->timeout != 0 && alt_deadline_passed(deadline))
 		{
 			return -ETIMEDOUT;
 		}
@@ -221,46 +278,321 @@ void alt_up_ps2_clear_fifo(alt_up_ps2_dev *ps2)
 	} while (num > 0);
 }
 
+//////////////////////////////////////////////////////////////
+// Command Engine
+
+typedef struct
+{
+	alt_u8 bytes[2];
+	alt_u8 len;
+	alt_u8 tries;
+} alt_up_ps2_cmd;
+
+typedef char alt_up_ps2_cmd_queue_size_is_not_a_power_of_two[
+	(ALT_UP_PS2_CMD_QUEUE_SIZE & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)) ? -1 : 1];
+
+volatile alt_u32 alt_up_ps2_cmd_wait = ALT_UP_PS2_CMD_WAIT_NONE;
+alt_up_ps2_cmd_stats alt_up_ps2_cmd_stat;
+
+static alt_up_ps2_dev *cmd_dev;
+static alt_up_ps2_cmd cmd_queue[ALT_UP_PS2_CMD_QUEUE_SIZE];
+// head: next free slot, tail: command in flight
+static alt_u32 cmd_head = 0;
+static alt_u32 cmd_tail = 0;
+// byte of the tail command in flight
+static alt_u32 cmd_pos = 0;
+static alt_up_ps2_cmd_callback cmd_callback = NULL;
+
+static void cmd_finish(int status);
+static void cmd_timeout(void *context);
+static void cmd_reply(alt_u32 reply);
+
+// runs while a reply is awaited
+static alt_timer cmd_timer = ALT_TIMER_INIT(cmd_timeout, NULL);
+
+// send byte cmd_pos of the tail command, with interrupts disabled
+static void cmd_send(void)
+{
+	alt_up_ps2_cmd *cmd = &cmd_queue[cmd_tail & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)];
+
+	alt_up_ps2_cmd_wait = ALT_UP_PS2_CMD_WAIT_ACK;
+	alt_up_ps2_cmd_stat.sent++;
+	if (alt_up_ps2_write_data_byte(cmd_dev, cmd->bytes[cmd_pos]) != 0)
+		cmd_finish(-EIO);
+	else
+		alt_timer_arm(&cmd_timer, ALT_UP_PS2_TIMEOUT_US, 0);
+}
+
+// no reply in time: send the byte again, or give up
+static void cmd_timeout(void *context)
+{
+	alt_up_ps2_cmd *cmd = &cmd_queue[cmd_tail & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)];
+
+	if (cmd_tail == cmd_head)
+		return;
+
+	alt_up_ps2_cmd_stat.timeouts++;
+	if (alt_up_ps2_cmd_wait == ALT_UP_PS2_CMD_WAIT_ACK && ++cmd->tries < ALT_UP_PS2_CMD_TRIES)
+		cmd_send();
+	else
+		cmd_finish(-ETIMEDOUT);
+}
+
+// drop the tail command and start the next one
+static void cmd_finish(int status)
+{
+	alt_u8 byte;
+
+	do
+	{
+		byte = cmd_queue[cmd_tail & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)].bytes[0];
+		cmd_tail++;
+		cmd_pos = 0;
+		alt_up_ps2_cmd_wait = ALT_UP_PS2_CMD_WAIT_NONE;
+		if (status == 0)
+			alt_up_ps2_cmd_stat.done++;
+		else
+			alt_up_ps2_cmd_stat.failed++;
+		if (cmd_callback != NULL)
+			cmd_callback(byte, status);
+		if (cmd_tail == cmd_head)
+		{
+			alt_timer_cancel(&cmd_timer);
+			return;
+		}
+
+		// a failed write finishes the next command here instead of recursing
+		alt_up_ps2_cmd_wait = ALT_UP_PS2_CMD_WAIT_ACK;
+		alt_up_ps2_cmd_stat.sent++;
+		status = alt_up_ps2_write_data_byte(cmd_dev,
+			cmd_queue[cmd_tail & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)].bytes[0]) ? -EIO : 0;
+	} while (status != 0);
+
+	alt_timer_arm(&cmd_timer, ALT_UP_PS2_TIMEOUT_US, 0);
+}
+
+int alt_up_ps2_cmd_queue(alt_up_ps2_dev *ps2, alt_u8 cmd, alt_u8 arg, alt_u32 len)
+{
+	alt_irq_context irq_context;
+	alt_up_ps2_cmd *slot;
+
+	if (len < 1 || len > 2)
+		return -EINVAL;
+
+	irq_context = alt_irq_disable_all();
+	if (cmd_head - cmd_tail >= ALT_UP_PS2_CMD_QUEUE_SIZE)
+	{
+		alt_irq_enable_all(irq_context);
+		return -EAGAIN;
+	}
+	slot = &cmd_queue[cmd_head & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)];
+	slot->bytes[0] = cmd;
+	slot->bytes[1] = arg;
+	slot->len = (alt_u8)len;
+	slot->tries = 0;
+	cmd_dev = ps2;
+	alt_up_ps2_cmd_stat.queued++;
+	if (cmd_head++ == cmd_tail)
+		cmd_send();
+	alt_irq_enable_all(irq_context);
+	return 0;
+}
+
+int alt_up_ps2_cmd_reset(alt_up_ps2_dev *ps2)
+{
+	return alt_up_ps2_cmd_queue(ps2, PS2_CMD_RESET, 0, 1);
+}
+
+int alt_up_ps2_cmd_set_leds(alt_up_ps2_dev *ps2, alt_u8 leds)
+{
+	return alt_up_ps2_cmd_queue(ps2, PS2_CMD_SET_LEDS, leds & 0x07, 2);
+}
+
+int alt_up_ps2_cmd_set_typematic(alt_up_ps2_dev *ps2, alt_u8 rate_delay)
+{
+	return alt_up_ps2_cmd_queue(ps2, PS2_CMD_TYPEMATIC, rate_delay & 0x7f, 2);
+}
+
+int alt_up_ps2_cmd_set_scan_code_set(alt_up_ps2_dev *ps2, alt_u8 set)
+{
+	if (set < 1 || set > 3)
+		return -EINVAL;
+	return alt_up_ps2_cmd_queue(ps2, PS2_CMD_SCAN_CODE_SET, set, 2);
+}
+
+alt_u32 alt_up_ps2_cmd_pending(void)
+{
+	return cmd_head - cmd_tail;
+}
+
+void alt_up_ps2_cmd_set_callback(alt_up_ps2_cmd_callback callback)
+{
+	cmd_callback = callback;
+}
+
+void alt_up_ps2_cmd_reply(alt_u32 reply)
+{
+	alt_irq_context irq_context;
+
+	// with ALT_IRQ_NESTING the timeout could preempt the reply and
+	// complete the command
+	irq_context = alt_irq_disable_all();
+	cmd_reply(reply);
+	alt_irq_enable_all(irq_context);
+}
+
+// interrupts disabled: cmd_tail cannot move under the reply
+static void cmd_reply(alt_u32 reply)
+{
+	alt_up_ps2_cmd *cmd;
+
+	if (cmd_tail == cmd_head)
+	{
+		alt_up_ps2_cmd_stat.stray++;
+		return;
+	}
+	cmd = &cmd_queue[cmd_tail & (ALT_UP_PS2_CMD_QUEUE_SIZE - 1)];
+
+	switch (reply)
+	{
+		case PS2_ACK:
+			if (alt_up_ps2_cmd_wait != ALT_UP_PS2_CMD_WAIT_ACK)
+				break;
+			cmd->tries = 0;
+			if (++cmd_pos < cmd->len)
+				cmd_send();
+			else if (cmd->bytes[0] == PS2_CMD_RESET)
+			{
+				alt_up_ps2_cmd_wait = ALT_UP_PS2_CMD_WAIT_BAT;
+				alt_timer_arm(&cmd_timer, ALT_UP_PS2_BAT_TIMEOUT_US, 0);
+			}
+			else
+				cmd_finish(0);
+			return;
+		case PS2_RESEND:
+			if (alt_up_ps2_cmd_wait != ALT_UP_PS2_CMD_WAIT_ACK)
+				break;
+			alt_up_ps2_cmd_stat.resends++;
+			if (++cmd->tries < ALT_UP_PS2_CMD_TRIES)
+				cmd_send();
+			else
+				cmd_finish(-EIO);
+			return;
+		case PS2_BAT_PASS:
+		case PS2_BAT_FAIL:
+			if (alt_up_ps2_cmd_wait != ALT_UP_PS2_CMD_WAIT_BAT)
+				break;
+			cmd_finish(reply == PS2_BAT_PASS ? 0 : -EIO);
+			return;
+		default:
+			break;
+	}
+	alt_up_ps2_cmd_stat.stray++;
+}
+
 //////////////////////////////////////////////////////////////
 // FD Functions
 int alt_up_ps2_read_fd (alt_fd* fd, char* ptr, int len)
 {
 	alt_up_ps2_dev *ps2 = (alt_up_ps2_dev*) fd->dev;
-	int status = 0;
+	alt_ring *ring = ps2->ring;
+	alt_irq_context irq_context;
+	alt_u8 *data;
+	alt_u32 n;
 	int count = 0;
-	while (count < len);
+
+	if (ring == NULL)
+	{
+		// no receive interrupt: wait for the first byte, then take the rest
+		// of the FIFO
+		if (len > 0 && !(fd->fd_flags & ALT_O_NONBLOCK))
+		{
+			if (alt_up_ps2_read_data_byte_timeout(ps2, (unsigned char *)ptr) != 0)
+				return -ETIMEDOUT;
+			count++;
+		}
+		while (count < len && alt_up_ps2_read_data_byte(ps2, (unsigned char *)ptr + count) == 0)
+			count++;
+		return (count == 0 && len > 0) ? -EWOULDBLOCK : count;
+	}
+
+	while (1)
 	{
-		status = alt_up_ps2_read_data_byte_timeout(ps2, (unsigned char *)ptr++);
-		if (status!=0)
+		// everything available: one copy, two if it wraps
+		while (count < len && (n = alt_ring_peek(ring, &data)) != 0)
+		{
+			if (n > (alt_u32)(len - count))
+				n = len - count;
+			memcpy(ptr + count, data, n);
+			alt_ring_consume(ring, n);
+			count += n;
+		}
+		if (count != 0 || len <= 0)
 			return count;
-		count++;
-	} 
-	return count;
+		if (fd->fd_flags & ALT_O_NONBLOCK)
+			return -EWOULDBLOCK;
+
+		// same check as the idle sleep in alt_sched_run(): a byte arriving
+		// after it leaves its interrupt pending and WFI returns at once
+		irq_context = alt_irq_disable_all();
+		if (alt_ring_count(ring) == 0)
+			ridecore_cpu_sleep();
+		alt_irq_enable_all(irq_context);
+	}
 }
 
 int alt_up_ps2_write_fd (alt_fd* fd, const char* ptr, int len)
 {
 	alt_up_ps2_dev *ps2 = (alt_up_ps2_dev*) fd->dev;
+	alt_irq_context irq_context;
 	int status = 0;
 	int count = 0;
+
+	if (ps2->ring == NULL)
+	{
+		while (count < len)
+		{
+			status = alt_up_ps2_write_data_byte(ps2, *(ptr++) );
+			if (status!=0)
+				return count;
+			count++;
+		}
+		return count;
+	}
+
+	// one byte per command: the device acknowledges every byte
 	while (count < len)
 	{
-		status = alt_up_ps2_write_data_byte(ps2, *(ptr++) );
-		if (status!=0)
-			return count;
-		count++;
+		status = alt_up_ps2_cmd_queue(ps2, (alt_u8)ptr[count], 0, 1);
+		if (status == 0)
+		{
+			count++;
+			continue;
+		}
+		if (status != -EAGAIN || (fd->fd_flags & ALT_O_NONBLOCK))
+			break;
+
+		// queue full: sleep until an acknowledgment makes room
+		irq_context = alt_irq_disable_all();
+		if (alt_up_ps2_cmd_pending() >= ALT_UP_PS2_CMD_QUEUE_SIZE)
+			ridecore_cpu_sleep();
+		alt_irq_enable_all(irq_context);
 	}
+	if (count == 0 && len > 0)
+		return (status == -EAGAIN) ? -EWOULDBLOCK : status;
 	return count;
 }
-/*
+
+void alt_up_ps2_set_ring(alt_up_ps2_dev *ps2, alt_ring *ring)
+{
+	ps2->ring = ring;
+}
+
 alt_up_ps2_dev* alt_up_ps2_open_dev(const char* name)
 {
   // find the device from the device list 
-  // (see altera_hal/HAL/inc/priv/alt_file.h 
-  // and altera_hal/HAL/src/alt_find_dev.c 
-  // for details)
+  // (see HAL/inc/sys/alt_dev.h and HAL/src/alt_dev.c for details)
   alt_up_ps2_dev *dev = (alt_up_ps2_dev*)alt_find_dev(name, &alt_dev_list);
 
   return dev;
 }
-*/
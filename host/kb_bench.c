@@ -0,0 +1,186 @@
+/*
+ * kb_bench -- host throughput benchmark of the keyboard decode path
+ *
+ * Builds a synthetic stream of random key strokes (make and break code
+ * of every key in key_descs, E0-prefixed where needed) and runs it
+ *
+ *   decode   straight through kb_decode()
+ *   driver   through the PS/2 receive FIFO of the MMIO model, read back
+ *            byte by byte with alt_up_ps2_read_data_byte()
+ *
+ * reporting decoded key events per second. Every event is checked
+ * against the stroke that produced it; a mismatch fails the run, so a
+ * broken decoder is caught as well as a slow one.
+ *
+ * Usage: kb_bench [strokes] [rounds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../keyboard.h"
+#include "../drivers/inc/altera_up_avalon_ps2.h"
+#include "mmio_mock.h"
+
+ALTERA_UP_AVALON_PS2_INSTANCE(PS2_KEYBOARD_0, ps2_keyboard_0);
+
+// bytes handed to kb_decode() at once, the event queue must hold the
+// events of one chunk (at most one per byte)
+#define CHUNK 16
+typedef char chunk_does_not_fit_the_event_queue[(CHUNK <= KB_EVENT_QUEUE_SIZE) ? 1 : -1];
+
+static alt_u8* stream;
+static alt_u32 stream_len;
+static alt_u8* expected;	// key of each event, make and break alternate
+static alt_u32 expected_num;
+static alt_u32 checked;
+
+static alt_u8 keys[SCAN_CODE_NUM];
+static alt_u32 key_num;
+
+// keys whose make code decodes back to them (skips table aliases)
+static void collect_keys(void)
+{
+	alt_u32 k;
+	const alt_u8* index;
+
+	for (k = 0; k < SCAN_CODE_NUM; k++)
+	{
+		index = (key_descs[k].flags & KEY_FLAG_EXTENDED) ?
+			multi_byte_key_index : single_byte_key_index;
+		if (key_descs[k].make_code != 0 && index[key_descs[k].make_code] == k)
+			keys[key_num++] = (alt_u8)k;
+	}
+}
+
+static void build_stream(alt_u32 strokes)
+{
+	alt_u32 i, seed = 12345;
+	alt_u8 k, code;
+
+	stream = malloc(strokes * 5);
+	expected = malloc(strokes * 2);
+	if (stream == NULL || expected == NULL)
+	{
+		fprintf(stderr, "kb_bench: out of memory\n");
+		exit(1);
+	}
+
+	for (i = 0; i < strokes; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		k = keys[(seed >> 16) % key_num];
+		code = key_descs[k].make_code;
+
+		if (key_descs[k].flags & KEY_FLAG_EXTENDED)
+			stream[stream_len++] = 0xE0;
+		stream[stream_len++] = code;
+		if (key_descs[k].flags & KEY_FLAG_EXTENDED)
+			stream[stream_len++] = 0xE0;
+		stream[stream_len++] = 0xF0;
+		stream[stream_len++] = code;
+
+		expected[expected_num++] = k;
+		expected[expected_num++] = k;
+	}
+}
+
+static void check_events(void)
+{
+	kb_event* events;
+	alt_u32 i, n;
+
+	n = kb_event_peek(&events);
+	for (i = 0; i < n; i++, checked++)
+	{
+		if (checked >= expected_num ||
+			events[i].key != expected[checked] ||
+			((events[i].flags & KB_EVENT_BREAK) != 0) != (checked & 1))
+		{
+			fprintf(stderr, "kb_bench: event %u: key %u flags %02X, expected key %u\n",
+				checked, events[i].key, events[i].flags,
+				checked < expected_num ? expected[checked] : KEY_NONE);
+			exit(1);
+		}
+	}
+	kb_event_consume(n);
+	if (n != 0)
+		check_events();
+}
+
+static void run_decode(void)
+{
+	alt_u32 i, n;
+
+	for (i = 0; i < stream_len; i += n)
+	{
+		n = (stream_len - i < CHUNK) ? stream_len - i : CHUNK;
+		kb_decode(stream + i, NULL, n);
+		check_events();
+	}
+}
+
+static void run_driver(void)
+{
+	alt_u8 chunk[CHUNK];
+	alt_u32 i = 0, n;
+
+	while (i < stream_len || host_ps2_pending())
+	{
+		i += host_ps2_inject(stream + i, stream_len - i);
+
+		for (n = 0; n < CHUNK; n++)
+		{
+			if (alt_up_ps2_read_data_byte(&ps2_keyboard_0, &chunk[n]) != 0)
+				break;
+		}
+		kb_decode(chunk, NULL, n);
+		check_events();
+	}
+}
+
+static void report(const char* name, void (*run)(void), alt_u32 rounds)
+{
+	alt_u64 start, ns, best = ~0ULL;
+	alt_u32 r;
+
+	for (r = 0; r < rounds; r++)
+	{
+		checked = 0;
+		start = ridecore_cpu_get_cycle64();
+		run();
+		ns = ridecore_cpu_get_cycle64() - start;
+		if (checked != expected_num)
+		{
+			fprintf(stderr, "kb_bench: %s decoded %u of %u events\n", name, checked, expected_num);
+			exit(1);
+		}
+		if (ns < best)
+			best = ns;
+	}
+
+	printf("%-8s %10.0f keys/s %8.2f ns/byte\n", name,
+		expected_num * 1e9 / best, (double)best / stream_len);
+}
+
+int main(int argc, char* argv[])
+{
+	alt_u32 strokes = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1000000;
+	alt_u32 rounds = (argc > 2) ? strtoul(argv[2], NULL, 0) : 5;
+
+	host_mmio_reset();
+	collect_keys();
+	build_stream(strokes);
+	printf("%u strokes, %u events, %u bytes, best of %u\n",
+		strokes, expected_num, stream_len, rounds);
+
+	report("decode", run_decode, rounds);
+	report("driver", run_driver, rounds);
+
+	if (kb_event_overflow)
+	{
+		fprintf(stderr, "kb_bench: %u events dropped\n", kb_event_overflow);
+		return 1;
+	}
+	return 0;
+}
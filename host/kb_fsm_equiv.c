@@ -0,0 +1,207 @@
+/*
+ * kb_fsm_equiv -- host equivalence test of the table-driven decode FSM
+ *
+ * Drives kb_fsm_table (keyboard.c) and the nested-switch get_next_state()
+ * it replaced with every sequence of 1 to 3 bytes, 16843008 sequences,
+ * each starting from STATE_INIT. After every byte the two must agree on
+ * the next state and the decode mode, and on the latched scan code byte
+ * once STATE_DONE is reached. Every mismatch is reported, up to ten,
+ * after which the run stops; the exit status is non-zero if there was
+ * any.
+ *
+ * Usage: kb_fsm_equiv
+ */
+
+#include <stdio.h>
+
+// the table and the state enum are private to keyboard.c
+#include "../keyboard.c"
+
+////////////////////////////////////////////////////////////////////
+// Reference: the decode FSM before kb_fsm_table
+
+static const alt_u8 single_byte_make_code[SCAN_CODE_NUM] = { 0x1C, 0x32, 0x21, 0x23, 0x24,
+	0x2B, 0x34, 0x33, 0x43, 0x3B, 0x42, 0x4B, 0x3A, 0x31, 0x44, 0x4D, 0x15,
+	0x2D, 0x1B, 0x2C, 0x3C, 0x2A, 0x1D, 0x22, 0x35, 0x1A, 0x45, 0x16, 0x1E,
+	0x26, 0x25, 0x2E, 0x36, 0x3D, 0x3E, 0x46, 0x0E, 0x4E, 0x55, 0x5D, 0x66,
+	0x29, 0x0D, 0x58, 0x12, 0x14, 0, 0x11, 0x59, 0, 0, 0, 0, 0x5A, 0x76,
+	0x05, 0x06, 0x04, 0x0C, 0x03, 0x0B, 0x83, 0x0A, 0x01, 0x09, 0x78, 0x07,
+	0x7E, 0x54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x77, 0, 0x7C, 0x7B, 0x79, 0,
+	0x71, 0x70, 0x69, 0x72, 0x7A, 0x6B, 0x73, 0x74, 0x6C, 0x75, 0x7D, 0x5B,
+	0x4C, 0x52, 0x41, 0x49, 0x4A };
+
+static unsigned get_single_byte_make_code_index(alt_u8 code)
+{
+	unsigned i;
+	for (i = 0; i < SCAN_CODE_NUM; i++ )
+	{
+		if ( single_byte_make_code[i] == code )
+			return i;
+	}
+	return SCAN_CODE_NUM;
+}
+
+// the ASCII value is not part of the comparison, the key tables are
+static DECODE_STATE get_next_state(DECODE_STATE state, alt_u8 byte,
+		KB_CODE_TYPE *decode_mode, alt_u8 *buf)
+{
+	DECODE_STATE next_state = STATE_INIT;
+	unsigned idx = SCAN_CODE_NUM;
+	switch (state)
+	{
+		case STATE_INIT:
+			if ( byte == 0xE0 )
+			{
+				// this could be a long break code or a long make code
+				next_state = STATE_LONG_CODE;
+			}
+			else if (byte == 0xF0)
+			{
+				// it is a break code
+				next_state = STATE_BREAK_CODE;
+			}
+			else
+			{
+				// it is a normal make code
+				idx = get_single_byte_make_code_index(byte);
+				if ( (idx < 40 || idx == 68 || idx > 79) && ( idx != SCAN_CODE_NUM ) )
+				{
+					*decode_mode = KB_ASCII_MAKE_CODE;
+					*buf = byte;
+				}
+				else
+				{
+					*decode_mode = KB_BINARY_MAKE_CODE;
+					*buf = byte;
+				}
+				next_state = STATE_DONE;
+			}
+			break;
+		case STATE_LONG_CODE:
+			if ( byte != 0xF0 && byte!= 0xE0)
+			{
+				*decode_mode = KB_LONG_BINARY_MAKE_CODE;
+				*buf = byte;
+				next_state = STATE_DONE;
+			}
+			else
+			{
+				*decode_mode = KB_BREAK_CODE;
+				next_state = STATE_LONG_BREAK_CODE;
+			}
+			break;
+		case STATE_BREAK_CODE:
+			if ( byte != 0xF0 && byte != 0xE0)
+			{
+				*decode_mode = KB_BREAK_CODE;
+				*buf = byte;
+				next_state = STATE_DONE;
+			}
+			else
+			{
+				next_state = STATE_BREAK_CODE;
+				*decode_mode = KB_BREAK_CODE;
+			}
+			break;
+		case STATE_LONG_BREAK_CODE:
+			if ( byte != 0xF0 && byte != 0xE0)
+			{
+				*decode_mode = KB_LONG_BREAK_CODE;
+				*buf = byte;
+				next_state = STATE_DONE;
+			}
+			else
+			{
+				next_state = STATE_LONG_BREAK_CODE;
+				*decode_mode = KB_LONG_BREAK_CODE;
+			}
+			break;
+		default:
+			*decode_mode = KB_INVALID_CODE;
+			next_state = STATE_INIT;
+	}
+	return next_state;
+}
+////////////////////////////////////////////////////////////////////
+
+static alt_u32 mismatches;
+
+static void report(const alt_u8* seq, alt_u32 len, alt_u32 at, const char* what,
+	unsigned ref, unsigned table)
+{
+	alt_u32 i;
+
+	fprintf(stderr, "kb_fsm_equiv: sequence");
+	for (i = 0; i < len; i++)
+		fprintf(stderr, " %02X", seq[i]);
+	fprintf(stderr, ", byte %u: %s %u, table %u\n", at, what, ref, table);
+	mismatches++;
+}
+
+// run seq[0..len) through both FSMs, the way kb_decode() steps them
+static int check(const alt_u8* seq, alt_u32 len)
+{
+	DECODE_STATE ref_state = STATE_INIT, state = STATE_INIT;
+	KB_CODE_TYPE ref_mode, mode;
+	alt_u8 ref_buf = 0, action;
+	alt_u32 i;
+
+	for (i = 0; i < len; i++)
+	{
+		// the old decoder started every byte with KB_INVALID_CODE
+		ref_mode = KB_INVALID_CODE;
+		ref_state = get_next_state(ref_state, seq[i], &ref_mode, &ref_buf);
+
+		action = kb_fsm_table[state][scan_code_class[seq[i]]];
+		state = KB_ACTION_STATE(action);
+		mode = KB_ACTION_MODE(action);
+
+		if (state != ref_state)
+		{
+			report(seq, len, i, "state", ref_state, state);
+			return 0;
+		}
+		if (mode != ref_mode)
+		{
+			report(seq, len, i, "mode", ref_mode, mode);
+			return 0;
+		}
+		if (state == STATE_DONE)
+		{
+			// the table latches the byte that completed the code
+			if (seq[i] != ref_buf)
+			{
+				report(seq, len, i, "byte", ref_buf, seq[i]);
+				return 0;
+			}
+			ref_state = STATE_INIT;
+			state = STATE_INIT;
+		}
+	}
+	return 1;
+}
+
+int main(void)
+{
+	alt_u8 seq[3];
+	alt_u32 n, len, total = 0;
+
+	for (len = 1; len <= 3; len++)
+	{
+		for (n = 0; n < (1u << (8 * len)); n++)
+		{
+			seq[0] = (alt_u8)n;
+			seq[1] = (alt_u8)(n >> 8);
+			seq[2] = (alt_u8)(n >> 16);
+			total++;
+			if (!check(seq, len) && mismatches >= 10)
+			{
+				fprintf(stderr, "kb_fsm_equiv: too many mismatches\n");
+				return 1;
+			}
+		}
+	}
+
+	printf("kb_fsm_equiv: %u sequences, %u mismatches\n", total, mismatches);
+	return mismatches != 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * kb_host -- the keyboard path of the firmware, run on the host
+ *
+ * Scan code bytes are queued in the PS/2 receive FIFO of the MMIO model,
+ * read back through the altera_up_avalon_ps2 driver, decoded by
+ * kb_decode() and printed one event per line.
+ *
+ * With -m the bytes are mouse packets for ms_decode() instead. Their
+ * events are printed once the input ends, so consecutive movement
+ * packets show up merged.
+ *
+ * Usage: kb_host [-m] [1C F0 1C ...]     (no bytes: hex bytes from stdin)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../keyboard.h"
+#include "../mouse.h"
+#include "../drivers/inc/altera_up_avalon_ps2.h"
+#include "mmio_mock.h"
+
+ALTERA_UP_AVALON_PS2_INSTANCE(PS2_KEYBOARD_0, ps2_keyboard_0);
+
+static void print_events(void)
+{
+	kb_event* events;
+	alt_u32 i, n;
+
+	while ((n = kb_event_peek(&events)) != 0)
+	{
+		for (i = 0; i < n; i++)
+		{
+			printf("%-5s %-8s code %02X mods %02X\n",
+				(events[i].flags & KB_EVENT_BREAK) ? "break" : "make",
+				events[i].key != KEY_NONE ? key_descs[events[i].key].name : "?",
+				events[i].code, events[i].modifiers);
+		}
+		kb_event_consume(n);
+	}
+}
+
+static void print_mouse_events(void)
+{
+	ms_event* events;
+	alt_u32 i, n;
+
+	while ((n = ms_event_peek(&events)) != 0)
+	{
+		for (i = 0; i < n; i++)
+		{
+			printf("move dx %d dy %d dz %d buttons %X packets %u flags %X\n",
+				events[i].dx, events[i].dy, events[i].dz, events[i].buttons,
+				events[i].packets, events[i].flags);
+		}
+		ms_event_consume(n);
+	}
+}
+
+static int mouse = 0;
+
+static void feed(alt_u8 byte)
+{
+	alt_u8 data;
+
+	host_ps2_inject(&byte, 1);
+	while (alt_up_ps2_read_data_byte(&ps2_keyboard_0, &data) == 0)
+	{
+		if (mouse)
+			ms_decode(&data, NULL, 1);
+		else
+			kb_decode(&data, NULL, 1);
+	}
+	if (!mouse)
+		print_events();
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int byte;
+	int i = 1;
+
+	host_mmio_reset();
+	alt_up_ps2_init(&ps2_keyboard_0);
+	printf("device type %d\n", ps2_keyboard_0.device_type);
+
+	if (argc > 1 && strcmp(argv[1], "-m") == 0)
+	{
+		mouse = 1;
+		i++;
+	}
+
+	if (argc > i)
+	{
+		for (; i < argc; i++)
+			feed((alt_u8)strtoul(argv[i], NULL, 16));
+	}
+	else
+	{
+		while (scanf("%x", &byte) == 1)
+			feed((alt_u8)byte);
+	}
+
+	if (mouse)
+	{
+		print_mouse_events();
+		printf("%u packets, %u merged, %u bytes resynced\n",
+			ms_stats.packets, ms_stats.merged, ms_stats.resyncs);
+	}
+
+	if (kb_event_overflow)
+		printf("%u events dropped\n", kb_event_overflow);
+	return 0;
+}
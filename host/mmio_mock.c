@@ -0,0 +1,169 @@
+/*
+ * mmio_mock -- software MMIO backend for host (ALT_HOST) builds,
+ * see mmio_mock.h
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../HAL/inc/ridecore.h"
+#include "../drivers/inc/altera_up_avalon_ps2_regs.h"
+#include "mmio_mock.h"
+
+#define PS2_ACK      0xFA
+#define PS2_BAT_PASS 0xAA
+#define PS2_RESET    0xFF
+
+#define PLIC_REGS    5
+
+host_mmio_counters host_mmio_stats;
+alt_u32 host_cpu_mstatus;
+
+static alt_u8 ps2_fifo[HOST_PS2_FIFO_SIZE];
+static alt_u32 ps2_fifo_head;
+static alt_u32 ps2_fifo_tail;
+static alt_u32 ps2_ctrl;
+static int ps2_error;
+
+static alt_u32 plic_regs[PLIC_REGS];
+static alt_u32 clint_timecmp[2];
+
+static int ps2_push(alt_u8 byte)
+{
+	if (ps2_fifo_head - ps2_fifo_tail >= HOST_PS2_FIFO_SIZE)
+	{
+		host_mmio_stats.ps2_overrun++;
+		return 0;
+	}
+	ps2_fifo[ps2_fifo_head++ % HOST_PS2_FIFO_SIZE] = byte;
+	return 1;
+}
+
+static alt_u32 ps2_read_data(void)
+{
+	alt_u32 avail = ps2_fifo_head - ps2_fifo_tail;
+	alt_u8 byte;
+
+	if (avail == 0)
+		return 0;
+
+	byte = ps2_fifo[ps2_fifo_tail++ % HOST_PS2_FIFO_SIZE];
+	return (avail << ALT_UP_PS2_PORT_DATA_REG_RAVAIL_OFST) |
+		ALT_UP_PS2_PORT_DATA_REG_RVALID_MSK | byte;
+}
+
+static alt_u32 ps2_read_ctrl(void)
+{
+	alt_u32 ctrl = ps2_ctrl & ALT_UP_PS2_PORT_CTRL_REG_RE_MSK;
+
+	if (ps2_error)
+		ctrl |= ALT_UP_PS2_PORT_CTRL_REG_CE_MSK;
+	if (ctrl & ALT_UP_PS2_PORT_CTRL_REG_RE_MSK && ps2_fifo_head != ps2_fifo_tail)
+		ctrl |= ALT_UP_PS2_PORT_CTRL_REG_RI_MSK;
+	return ctrl;
+}
+
+static void ps2_command(alt_u8 byte)
+{
+	if (ps2_error)
+		return;
+
+	ps2_push(PS2_ACK);
+	if (byte == PS2_RESET)
+		ps2_push(PS2_BAT_PASS);
+}
+
+static void unmapped(const char* access, alt_u32 addr)
+{
+	fprintf(stderr, "mmio_mock: %s of unmapped address 0x%08x\n", access, addr);
+	abort();
+}
+
+alt_u32 host_mmio_read(alt_u32 addr)
+{
+	host_mmio_stats.reads++;
+
+	switch (addr)
+	{
+		case PS2_KEYBOARD_0_BASE:
+			return ps2_read_data();
+		case PS2_KEYBOARD_0_BASE + 4:
+			return ps2_read_ctrl();
+	}
+	if (addr >= PLIC_BASE && addr < PLIC_BASE + PLIC_REGS * 4)
+		return plic_regs[(addr - PLIC_BASE) >> 2];
+	if (addr == CLINT_BASE)
+		return (alt_u32)host_cpu_cycle();
+	if (addr == CLINT_BASE + 4)
+		return (alt_u32)(host_cpu_cycle() >> 32);
+	if (addr == CLINT_BASE + 8 || addr == CLINT_BASE + 12)
+		return clint_timecmp[(addr - CLINT_BASE - 8) >> 2];
+
+	unmapped("read", addr);
+	return 0;
+}
+
+void host_mmio_write(alt_u32 addr, alt_u32 wdata, alt_u32 size)
+{
+	host_mmio_stats.writes++;
+
+	switch (addr)
+	{
+		case PS2_KEYBOARD_0_BASE:
+			ps2_command((alt_u8)wdata);
+			return;
+		case PS2_KEYBOARD_0_BASE + 4:
+			ps2_ctrl = wdata;
+			return;
+	}
+	if (addr >= PLIC_BASE && addr < PLIC_BASE + PLIC_REGS * 4 && size == 4)
+	{
+		plic_regs[(addr - PLIC_BASE) >> 2] = wdata;
+		return;
+	}
+	if ((addr == CLINT_BASE + 8 || addr == CLINT_BASE + 12) && size == 4)
+	{
+		clint_timecmp[(addr - CLINT_BASE - 8) >> 2] = wdata;
+		return;
+	}
+
+	unmapped("write", addr);
+}
+
+alt_u64 host_cpu_cycle(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (alt_u64)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+alt_u32 host_ps2_inject(const alt_u8* data, alt_u32 count)
+{
+	alt_u32 i;
+
+	for (i = 0; i < count && host_ps2_pending() < HOST_PS2_FIFO_SIZE; i++)
+		ps2_push(data[i]);
+	return i;
+}
+
+alt_u32 host_ps2_pending(void)
+{
+	return ps2_fifo_head - ps2_fifo_tail;
+}
+
+void host_ps2_set_error(int error)
+{
+	ps2_error = error;
+}
+
+void host_mmio_reset(void)
+{
+	ps2_fifo_head = ps2_fifo_tail = 0;
+	ps2_ctrl = 0;
+	ps2_error = 0;
+	for (alt_u32 i = 0; i < PLIC_REGS; i++)
+		plic_regs[i] = 0;
+	clint_timecmp[0] = clint_timecmp[1] = 0xFFFFFFFF;
+}
@@ -0,0 +1,56 @@
+/*
+ * mmio_mock -- software MMIO backend for host (ALT_HOST) builds
+ *
+ * With ALT_HOST, ridecore_host.h routes __builtin_ldwio/__builtin_stwio
+ * and friends here. The model covers the registers the keyboard path
+ * touches:
+ *
+ *   PS2_KEYBOARD_0_BASE  data register: reads pop the receive FIFO and
+ *                        return DATA, RVALID and RAVAIL (counting the
+ *                        byte just read); writes send a command byte,
+ *                        which the modelled device acknowledges with 0xFA
+ *                        (0xFA 0xAA for reset).
+ *                        control register: RE is stored, RI reads as
+ *                        RE && FIFO not empty, CE as set by
+ *                        host_ps2_set_error().
+ *   PLIC_BASE            five plain registers.
+ *   CLINT_BASE           mtime reads the host clock (host_cpu_cycle),
+ *                        mtimecmp is stored. No interrupt is raised.
+ *
+ * Any other address aborts with a message.
+ */
+
+#ifndef __MMIO_MOCK_H__
+#define __MMIO_MOCK_H__
+
+#include "../HAL/inc/alt_types.h"
+
+// receive FIFO depth of the modelled PS/2 port (the IP core has 256)
+#define HOST_PS2_FIFO_SIZE 256
+
+typedef struct
+{
+	alt_u64 reads;
+	alt_u64 writes;
+	// bytes dropped because the receive FIFO was full
+	alt_u64 ps2_overrun;
+} host_mmio_counters;
+
+extern host_mmio_counters host_mmio_stats;
+
+/*
+ * Queue scan code bytes in the PS/2 receive FIFO as if the keyboard had
+ * sent them. Returns the number of bytes that fit.
+ */
+alt_u32 host_ps2_inject(const alt_u8* data, alt_u32 count);
+
+// bytes waiting in the PS/2 receive FIFO
+alt_u32 host_ps2_pending(void);
+
+// make the next command writes fail with CE set (1) or succeed (0)
+void host_ps2_set_error(int error);
+
+// forget all device state
+void host_mmio_reset(void);
+
+#endif /* __MMIO_MOCK_H__ */
@@ -0,0 +1,195 @@
+#include "HAL/inc/ridecore.h"
+#include "HAL/inc/sys/alt_ring.h"
+#include "keyboard.h"
+
+// States for the Keyboard Decode FSM 
+typedef enum
+{
+	STATE_INIT,
+	STATE_LONG_CODE,
+	STATE_BREAK_CODE ,
+	STATE_LONG_BREAK_CODE ,
+	STATE_DONE 
+} DECODE_STATE;
+
+/* FSM Diagram (Main transitions)
+ * Normal bytes: bytes that are not 0xF0 or 0xE0
+  +--<--+
+  |     |                                   
+  |     |
+  V    INIT ------ 0xF0 ----> BREAK CODE
+  |     |                         |
+  |     |         LONG_BREAK_CODE-+
+  |    0xE0      /                |
+ Normal |       /                Normal
+  |     |     0xF0                |
+  |     V     /                   |
+  |    LONG  /                    V
+  |    CODE --- Normal -------> DONE
+  |          (long make code)    /|\
+  |                               |
+  +-------------------------------|
+
+ * The FSM is compiled into kb_fsm_table, indexed by the current state and
+ * the class of the received byte (scan_code_class). Each entry packs the
+ * next state and the decode mode that is valid once the next state is
+ * STATE_DONE, so one load replaces the per-state prefix tests.
+ */
+#define KB_ACTION(next, mode)	((alt_u8)((next) | ((mode) << 3)))
+#define KB_ACTION_STATE(act)	((DECODE_STATE)((act) & 0x7))
+#define KB_ACTION_MODE(act)		((KB_CODE_TYPE)((act) >> 3))
+
+static const alt_u8 kb_fsm_table[STATE_DONE + 1][KB_CLASS_NUM] =
+{
+	// STATE_INIT
+	{
+		KB_ACTION(STATE_DONE, KB_BINARY_MAKE_CODE),			// KB_CLASS_BINARY
+		KB_ACTION(STATE_DONE, KB_ASCII_MAKE_CODE),			// KB_CLASS_ASCII
+		KB_ACTION(STATE_LONG_CODE, KB_INVALID_CODE),		// KB_CLASS_E0
+		KB_ACTION(STATE_BREAK_CODE, KB_INVALID_CODE)		// KB_CLASS_F0
+	},
+	// STATE_LONG_CODE
+	{
+		KB_ACTION(STATE_DONE, KB_LONG_BINARY_MAKE_CODE),
+		KB_ACTION(STATE_DONE, KB_LONG_BINARY_MAKE_CODE),
+		KB_ACTION(STATE_LONG_BREAK_CODE, KB_BREAK_CODE),
+		KB_ACTION(STATE_LONG_BREAK_CODE, KB_BREAK_CODE)
+	},
+	// STATE_BREAK_CODE
+	{
+		KB_ACTION(STATE_DONE, KB_BREAK_CODE),
+		KB_ACTION(STATE_DONE, KB_BREAK_CODE),
+		KB_ACTION(STATE_BREAK_CODE, KB_BREAK_CODE),
+		KB_ACTION(STATE_BREAK_CODE, KB_BREAK_CODE)
+	},
+	// STATE_LONG_BREAK_CODE
+	{
+		KB_ACTION(STATE_DONE, KB_LONG_BREAK_CODE),
+		KB_ACTION(STATE_DONE, KB_LONG_BREAK_CODE),
+		KB_ACTION(STATE_LONG_BREAK_CODE, KB_LONG_BREAK_CODE),
+		KB_ACTION(STATE_LONG_BREAK_CODE, KB_LONG_BREAK_CODE)
+	},
+	// STATE_DONE
+	{
+		KB_ACTION(STATE_INIT, KB_INVALID_CODE),
+		KB_ACTION(STATE_INIT, KB_INVALID_CODE),
+		KB_ACTION(STATE_INIT, KB_INVALID_CODE),
+		KB_ACTION(STATE_INIT, KB_INVALID_CODE)
+	}
+};
+
+/*
+ * KB_EVENT_* flags for each decode mode
+ */
+static const alt_u8 kb_mode_flags[KB_INVALID_CODE + 1] =
+{
+	0,										// unused
+	KB_EVENT_ASCII,							// KB_ASCII_MAKE_CODE
+	0,										// KB_BINARY_MAKE_CODE
+	KB_EVENT_EXTENDED,						// KB_LONG_BINARY_MAKE_CODE
+	KB_EVENT_BREAK,							// KB_BREAK_CODE
+	KB_EVENT_BREAK | KB_EVENT_EXTENDED,		// KB_LONG_BREAK_CODE
+	0										// KB_INVALID_CODE
+};
+
+typedef char kb_event_queue_size_is_not_a_power_of_two
+	[(KB_EVENT_QUEUE_SIZE & (KB_EVENT_QUEUE_SIZE - 1)) ? -1 : 1];
+
+/*
+ * Key event queue. Same single-producer/single-consumer scheme as
+ * alt_ring: kb_decode() only writes the head, the consumer only the tail.
+ */
+static kb_event kb_events[KB_EVENT_QUEUE_SIZE];
+static volatile alt_u32 kb_event_head = 0;
+static volatile alt_u32 kb_event_tail = 0;
+alt_u32 kb_event_overflow = 0;
+
+static DECODE_STATE key_decode_state = STATE_INIT;
+static alt_u8 key_modifiers = 0;
+
+static void kb_emit(KB_CODE_TYPE decode_mode, alt_u8 code, alt_u32 cycle)
+{
+	alt_u32 head = kb_event_head;
+	alt_u8 flags = kb_mode_flags[decode_mode];
+	alt_u8 key;
+	kb_event* event;
+
+	if (flags & KB_EVENT_EXTENDED)
+		key = multi_byte_key_index[code];
+	else
+		key = single_byte_key_index[code];
+
+	// track the modifier keys even if the event itself is lost
+	if (key != KEY_NONE && key_descs[key].modifier)
+	{
+		if (flags & KB_EVENT_BREAK)
+			key_modifiers &= ~key_descs[key].modifier;
+		else
+			key_modifiers |= key_descs[key].modifier;
+	}
+
+	if (head - kb_event_tail >= KB_EVENT_QUEUE_SIZE)
+	{
+		kb_event_overflow++;
+		return;
+	}
+
+	event = &kb_events[head & (KB_EVENT_QUEUE_SIZE - 1)];
+	event->key = key;
+	event->code = code;
+	event->flags = flags;
+	event->modifiers = key_modifiers;
+	event->cycle = cycle;
+	event->decoded = ridecore_cpu_get_cycle();
+
+	ALT_RING_BARRIER();
+	kb_event_head = head + 1;
+}
+
+void kb_decode(const alt_u8* data, const alt_u32* stamps, alt_u32 count)
+{
+	alt_u32 i;
+	alt_u8 byte, action;
+
+	for (i = 0; i < count; i++)
+	{
+		byte = data[i];
+		action = kb_fsm_table[key_decode_state][scan_code_class[byte]];
+		key_decode_state = KB_ACTION_STATE(action);
+
+		if (key_decode_state == STATE_DONE)
+		{
+			kb_emit(KB_ACTION_MODE(action), byte,
+				stamps ? stamps[i] : ridecore_cpu_get_cycle());
+			key_decode_state = STATE_INIT;
+		}
+	}
+}
+
+alt_u32 kb_event_peek(kb_event** events)
+{
+	alt_u32 tail = kb_event_tail;
+	alt_u32 count = kb_event_head - tail;
+	alt_u32 offset = tail & (KB_EVENT_QUEUE_SIZE - 1);
+	alt_u32 contiguous = KB_EVENT_QUEUE_SIZE - offset;
+
+	ALT_RING_BARRIER();
+	*events = &kb_events[offset];
+	return (count < contiguous) ? count : contiguous;
+}
+
+void kb_event_consume(alt_u32 count)
+{
+	ALT_RING_BARRIER();
+	kb_event_tail += count;
+}
+
+alt_u32 kb_event_room(void)
+{
+	return KB_EVENT_QUEUE_SIZE - (kb_event_head - kb_event_tail);
+}
+
+alt_u8 kb_modifiers(void)
+{
+	return key_modifiers;
+}
@@ -0,0 +1,118 @@
+#ifndef __KEYBOARD_H__
+#define __KEYBOARD_H__
+
+#include "HAL/inc/alt_types.h"
+#include "keymap.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * @brief The enum type for the type of keyboard code received
+ **/
+typedef enum
+{
+	/** @brief Make code that corresponds to an ASCII character. For example, the ASCII make code for key <tt>[ A ] </tt> is 1C.
+	 */
+	KB_ASCII_MAKE_CODE = 1, 
+	/** @brief Make code that corresponds to a non-ASCII character. For example, the binary (non-ASCII) make code for key <tt> [Left Alt]</tt> is 11.
+	 */
+	KB_BINARY_MAKE_CODE = 2,
+	/** @brief Make code that has two bytes (the first byte is E0). For example, the long binary make code for key <tt>[Right Alt]</tt> is "E0 11".
+	 */
+	KB_LONG_BINARY_MAKE_CODE = 3,
+	/** @brief Break code that has two bytes (the first byte is F0). For example, the break code for key <tt>[ A ]</tt> is "F0 1C".
+	 */
+	KB_BREAK_CODE = 4,
+	/** @brief Long break code that has three bytes (with the first two bytes "E0 F0"). For example, the long break code for key <tt>[Right Alt]</tt> is "E0 F0 11".
+	 */
+	KB_LONG_BREAK_CODE = 5,
+	/** @brief Scan codes that the decoding FSM is unable to decode.
+	 */
+	KB_INVALID_CODE = 6
+} KB_CODE_TYPE;
+
+/*
+ * Key event flags
+ */
+// the key was released
+#define KB_EVENT_BREAK     0x01
+// long (E0-prefixed) code
+#define KB_EVENT_EXTENDED  0x02
+// make code of a key with an ASCII value (KB_ASCII_MAKE_CODE)
+#define KB_EVENT_ASCII     0x04
+
+/**
+ * @brief Decoded key event, 12 bytes.
+ **/
+typedef struct kb_event
+{
+	/// @brief key index into key_descs, KEY_NONE for a code that belongs to no key
+	alt_u8 key;
+	/// @brief last byte of the scan code (without the E0/F0 prefixes)
+	alt_u8 code;
+	/// @brief combination of the KB_EVENT_* bits
+	alt_u8 flags;
+	/// @brief KB_MOD_* keys held down once this event has been applied
+	alt_u8 modifiers;
+	/// @brief mcycle (low word) when the last byte of the code was received,
+	/// or when it was decoded if kb_decode() got no receive times
+	alt_u32 cycle;
+	/// @brief mcycle (low word) when the event was queued
+	alt_u32 decoded;
+} kb_event;
+
+/*
+ * Size of the key event queue, must be a power of two
+ */
+#ifndef KB_EVENT_QUEUE_SIZE
+#define KB_EVENT_QUEUE_SIZE 16
+#endif
+
+// events dropped because the queue was full
+extern alt_u32 kb_event_overflow;
+
+/**
+ * @brief Run scan code bytes through the decode FSM. Every complete make
+ * or break code is appended to the key event queue.
+ *
+ * @param data -- the received bytes.
+ * @param stamps -- receive time (mcycle) of each byte, or NULL.
+ * @param count -- number of bytes at \em data.
+ **/
+void kb_decode(const alt_u8* data, const alt_u32* stamps, alt_u32 count);
+
+/**
+ * @brief Look at the queued key events without removing them.
+ *
+ * @param events -- set to the oldest queued event.
+ *
+ * @return the number of events readable at \em events. Events that wrap
+ * around the end of the queue are returned by the next call.
+ **/
+alt_u32 kb_event_peek(kb_event** events);
+
+/**
+ * @brief Release \em count events returned by kb_event_peek().
+ **/
+void kb_event_consume(alt_u32 count);
+
+/**
+ * @brief Free entries in the key event queue. kb_decode() emits at most
+ * one event per byte, so this many bytes can be decoded without losing
+ * an event.
+ **/
+alt_u32 kb_event_room(void);
+
+/**
+ * @brief KB_MOD_* keys currently held down.
+ **/
+alt_u8 kb_modifiers(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __KEYBOARD_H__ */
@@ -0,0 +1,87 @@
+#ifndef __KEYMAP_H__
+#define __KEYMAP_H__
+
+#include "HAL/inc/alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#define SCAN_CODE_NUM  102
+
+/*
+ * Value stored in the reverse index tables for scan codes that do not
+ * belong to any key.
+ */
+#define KEY_NONE  0xFF
+
+/*
+ * Key descriptor flags
+ */
+// the single-byte make code decodes as KB_ASCII_MAKE_CODE
+#define KEY_FLAG_ASCII     0x01
+// the key has a single-byte make code
+#define KEY_FLAG_SINGLE    0x02
+// the key has a long (E0-prefixed) make code
+#define KEY_FLAG_EXTENDED  0x04
+
+/*
+ * Modifier key bits, see key_desc.modifier
+ */
+#define KB_MOD_LSHIFT  0x01
+#define KB_MOD_LCTRL   0x02
+#define KB_MOD_LGUI    0x04
+#define KB_MOD_LALT    0x08
+#define KB_MOD_RSHIFT  0x10
+#define KB_MOD_RCTRL   0x20
+#define KB_MOD_RGUI    0x40
+#define KB_MOD_RALT    0x80
+
+/*
+ * Byte classes seen by the decode FSM
+ */
+// make code of a key without ASCII value (or an unknown code)
+#define KB_CLASS_BINARY  0
+// make code of a key that decodes as KB_ASCII_MAKE_CODE
+#define KB_CLASS_ASCII   1
+// 0xE0 prefix of a long code
+#define KB_CLASS_E0      2
+// 0xF0 prefix of a break code
+#define KB_CLASS_F0      3
+#define KB_CLASS_NUM     4
+
+/**
+ * @brief Per-key descriptor. Packs the key name, its ASCII value and flags
+ * into one 8-byte entry so that a decoded key costs a single table access.
+ **/
+typedef struct key_desc {
+	/// @brief printable name of the key, e.g. "L SHFT"
+	const char *name;
+	/// @brief ASCII value of the key, 0 if there is none
+	char ascii;
+	/// @brief combination of the KEY_FLAG_* bits
+	alt_u8 flags;
+	/// @brief make code without the E0 prefix
+	alt_u8 make_code;
+	/// @brief KB_MOD_* bit of a modifier key, 0 for other keys
+	alt_u8 modifier;
+} key_desc;
+
+/*
+ * Tables generated at build time by tools/keymap_gen.c (keymap_tables.c)
+ */
+// key descriptors, indexed by key index
+extern const key_desc key_descs[SCAN_CODE_NUM];
+// scan code -> key index for single-byte make codes, KEY_NONE if unused
+extern const alt_u8 single_byte_key_index[256];
+// scan code -> key index for long (E0 xx) make codes, KEY_NONE if unused
+extern const alt_u8 multi_byte_key_index[256];
+// scan code -> KB_CLASS_*, the column index into the decode FSM table
+extern const alt_u8 scan_code_class[256];
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __KEYMAP_H__ */
@@ -1,331 +1,407 @@
 #include "HAL/inc/io.h"
-#include "HAL/inc/sys/alt_string.h"
+#include "HAL/inc/sys/alt_irq.h"
+#include "HAL/inc/sys/alt_ring.h"
+#include "HAL/inc/sys/alt_hist.h"
+#include "HAL/inc/sys/alt_timer.h"
+#include "HAL/inc/clint.h"
+#include "HAL/inc/sys/alt_sched.h"
+#include "keyboard.h"
+#include "mouse.h"
+#include "console.h"
 #include "drivers/inc/altera_up_avalon_ps2.h"
 
 volatile const unsigned int finish_addr = 0x00000000;
 volatile const unsigned int intdisp_addr = 0x00000004;
 volatile const unsigned int countdisp_addr = 0x000000a0;
 volatile const unsigned int flush_addr = 0x00002000;
-volatile const unsigned int kb_buffer_addr = 0x00000010;
 
-#define DISPLAY_CHAR(display_addr, chr) *((char*)(display_addr)) = chr
+//#define DISPLAY_CHAR(display_addr, chr) *((char*)(display_addr)) = chr
 //#define FINISH_PROGRAM *((int*)(finish_addr)) = 1
 //#define FLUSH_CACHE *((int*)(flush_addr)) = 0
 //#define DISPLAY_INT(num) *((int*)(intdisp_addr)) = num
-#define DISPLAY_CUT(num) *((int*)(countdisp_addr)) = num
-#define READ_KB_BUFF(num) *(((alt_u8*)(kb_buffer_addr)) + num)
+#define DISPLAY_CUT(num) *((volatile int*)(countdisp_addr)) = num
 
-/**
- * @brief The enum type for the type of keyboard code received
- **/
-typedef enum
+/*
+ * Allocate the device storage
+ */
+ALTERA_UP_AVALON_PS2_INSTANCE(PS2_KEYBOARD_0, ps2_keyboard_0);
+
+/*
+ * Drain statistics kept by the PS/2 interrupt handler (interrupt.S).
+ * The handler reads every pending byte before completing the PLIC claim,
+ * so bytes - irqs is the number of interrupt entries saved.
+ */
+typedef struct
 {
-	/** @brief Make code that corresponds to an ASCII character. For example, the ASCII make code for key <tt>[ A ] </tt> is 1C.
-	 */
-	KB_ASCII_MAKE_CODE = 1, 
-	/** @brief Make code that corresponds to a non-ASCII character. For example, the binary (non-ASCII) make code for key <tt> [Left Alt]</tt> is 11.
-	 */
-	KB_BINARY_MAKE_CODE = 2,
-	/** @brief Make code that has two bytes (the first byte is E0). For example, the long binary make code for key <tt>[Right Alt]</tt> is "E0 11".
-	 */
-	KB_LONG_BINARY_MAKE_CODE = 3,
-	/** @brief Break code that has two bytes (the first byte is F0). For example, the break code for key <tt>[ A ]</tt> is "F0 1C".
-	 */
-	KB_BREAK_CODE = 4,
-	/** @brief Long break code that has three bytes (with the first two bytes "E0 F0"). For example, the long break code for key <tt>[Right Alt]</tt> is "E0 F0 11".
-	 */
-	KB_LONG_BREAK_CODE = 5,
-	/** @brief Scan codes that the decoding FSM is unable to decode.
-	 */
-	KB_INVALID_CODE = 6
-} KB_CODE_TYPE;
-
-#define SCAN_CODE_NUM  102
-
-////////////////////////////////////////////////////////////////////
-// Table of scan code, make code and their corresponding values 
-// These data are useful for developing more features for the keyboard 
-//
-char *key_table[SCAN_CODE_NUM] = { "A", "B", "C", "D", "E", "F", "G", "H", "I", 
-			"J", "K", "L", "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", 
-			"X", "Y", "Z", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "`", 
-			"-", "=", "\\", "BKSP", "SPACE", "TAB", "CAPS", "L SHFT", "L CTRL", 
-			"L GUI", "L ALT", "R SHFT", "R CTRL", "R GUI", "R ALT", "APPS", 
-			"ENTER", "ESC", "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", 
-			"F10", "F11", "F12", "SCROLL", "[", "INSERT", "HOME", "PG UP", 
-			"DELETE", "END", "PG DN", "U ARROW", "L ARROW", "D ARROW", "R ARROW", 
-			"NUM", "KP /", "KP *", "KP -", "KP +", "KP ENTER", "KP .", "KP 0", 
-			"KP 1", "KP 2", "KP 3", "KP 4", "KP 5", "KP 6", "KP 7", "KP 8", "KP 9", 
-			"]", ";", "'", ",", ".", "/" };
-
-char ascii_codes[SCAN_CODE_NUM] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 
-	'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 
-	'W', 'X', 'Y', 'Z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 
-	'`', '-', '=', 0, 0x08, 0, 0x09, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0A, 
-	0x1B, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '[', 0, 0, 0, 0x7F, 0, 0, 
-	0, 0, 0, 0, 0, '/', '*', '-', '+', 0x0A, '.', '0', '1', '2', '3', '4', 
-	'5', '6', '7', '8', '9', ']', ';', '\'', ',', '.', '/' };
-
-alt_u8 single_byte_make_code[SCAN_CODE_NUM] = { 0x1C, 0x32, 0x21, 0x23, 0x24, 
-	0x2B, 0x34, 0x33, 0x43, 0x3B, 0x42, 0x4B, 0x3A, 0x31, 0x44, 0x4D, 0x15, 
-	0x2D, 0x1B, 0x2C, 0x3C, 0x2A, 0x1D, 0x22, 0x35, 0x1A, 0x45, 0x16, 0x1E, 
-	0x26, 0x25, 0x2E, 0x36, 0x3D, 0x3E, 0x46, 0x0E, 0x4E, 0x55, 0x5D, 0x66, 
-	0x29, 0x0D, 0x58, 0x12, 0x14, 0, 0x11, 0x59, 0, 0, 0, 0, 0x5A, 0x76, 
-	0x05, 0x06, 0x04, 0x0C, 0x03, 0x0B, 0x83, 0x0A, 0x01, 0x09, 0x78, 0x07, 
-	0x7E, 0x54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x77, 0, 0x7C, 0x7B, 0x79, 0, 
-	0x71, 0x70, 0x69, 0x72, 0x7A, 0x6B, 0x73, 0x74, 0x6C, 0x75, 0x7D, 0x5B, 
-	0x4C, 0x52, 0x41, 0x49, 0x4A };
-
-alt_u8 multi_byte_make_code[SCAN_CODE_NUM] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1F, 0, 0, 0x14, 0x27, 0x11, 0x2F, 0, 
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x70, 0x6C, 0x7D, 0x71, 
-	0x69, 0x7A, 0x75, 0x6B, 0x72, 0x74, 0, 0x4A, 0, 0, 0, 0x5A, 0, 0, 0, 0, 
-	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-////////////////////////////////////////////////////////////////////
-
-// States for the Keyboard Decode FSM 
-typedef enum
+	alt_u32 irqs;
+	alt_u32 bytes;
+	alt_u32 max_burst;
+	// [n]: interrupts that drained n bytes, [7]: 7 or more
+	alt_u32 burst_hist[8];
+} ps2_drain_stats;
+
+extern ps2_drain_stats ps2_irq_stats;
+// tasks made ready by ps2_isr (interrupt.S) after each drain
+extern alt_u32 ps2_irq_event;
+// PS/2 receive handler (interrupt.S), context is the receive ring
+extern void ps2_isr(void* context, alt_u32 id);
+
+/*
+ * Keyboard receive ring, filled and timestamped by ps2_isr
+ */
+#ifndef KB_RING_SIZE
+#define KB_RING_SIZE 64
+#endif
+ALT_RING_STAMPED_INSTANCE(kb_ring, KB_RING_SIZE);
+
+/*
+ * Tasks run by alt_sched_run(), higher numbers first. The decode task
+ * decodes no more bytes than the key event queue has room for and posts
+ * itself again for the rest; display runs first and empties the queue,
+ * so a burst is handled in steps without dropping events.
+ */
+// latency histograms, when nothing else is ready
+#define KB_TASK_STATS    0
+// kb_ring -> key or mouse events, posted by ps2_isr
+#define KB_TASK_DECODE   1
+// mouse events -> pointer, once a frame, posted by ms_frame_timer
+#define KB_TASK_MOUSE    2
+// key events -> display
+#define KB_TASK_DISPLAY  3
+// device detection steps, posted by kb_detect_timer
+#define KB_TASK_DETECT   4
+
+/*
+ * Mouse events are taken once per frame: the packets decoded in between
+ * are merged into one event (mouse.h)
+ */
+#ifndef MS_FRAME_US
+#define MS_FRAME_US 16384
+#endif
+
+/*
+ * The latency statistics below are left out of the board image to fit the
+ * memory map; build with KB_LATENCY_STATS=1 (LATENCY_STATS=1 in the
+ * Makefile) to take them.
+ */
+#ifndef KB_LATENCY_STATS
+#define KB_LATENCY_STATS 0
+#endif
+
+#if KB_LATENCY_STATS
+/*
+ * Wake-up latency: cycles from the entry of the interrupt that ended an
+ * idle period to the first byte decoded after it. Build with
+ * -DALT_SCHED_IDLE_SLEEP=0 to compare against busy polling.
+ */
+typedef struct
 {
-	STATE_INIT,
-	STATE_LONG_CODE,
-	STATE_BREAK_CODE ,
-	STATE_LONG_BREAK_CODE ,
-	STATE_DONE 
-} DECODE_STATE;
+	alt_u32 wakeups;
+	alt_u32 last;
+	alt_u32 min;
+	alt_u32 max;
+	alt_u64 total;
+} wake_latency_stats;
+
+wake_latency_stats kb_wake_stats = { 0, 0, 0xFFFFFFFF, 0, 0 };
 
 /*
- * Allocate the device storage
+ * Keystroke latency in cycles, one sample per key event:
+ *   rx_to_decode       ps2_isr reads the last byte of the code ->
+ *                      kb_decode() queues the key event
+ *   decode_to_display  -> its output is on the display, including the
+ *                      wait for the display task
+ *   rx_to_display      end to end
+ * Kept in one block, found by its magic word or dumped by symbol
+ * (tools/rvsim -d kb_latency).
  */
-ALTERA_UP_AVALON_PS2_INSTANCE(PS2_KEYBOARD_0, ps2_keyboard_0);
+#define KB_LATENCY_MAGIC 0x3154414c    // "LAT1"
 
-extern alt_u8 kb_wptr;
-alt_u8 kb_rptr = 0;
-char* print_addr = (char*)0x0;
-int count = 0;
+typedef struct
+{
+	alt_u32 magic;
+	// size of the block in bytes
+	alt_u32 size;
+	alt_hist rx_to_decode;
+	alt_hist decode_to_display;
+	alt_hist rx_to_display;
+} kb_latency_block;
+
+kb_latency_block kb_latency =
+{
+	KB_LATENCY_MAGIC,
+	sizeof(kb_latency_block),
+	ALT_HIST_INIT,
+	ALT_HIST_INIT,
+	ALT_HIST_INIT
+};
 
-static DECODE_STATE key_decode_state = STATE_INIT;
+/*
+ * Latency samples, taken by the display task and added to kb_latency by
+ * the stats task
+ */
+#define KB_SAMPLE_QUEUE_SIZE 16
 
-void ridecore_init(void)
+typedef struct
 {
-    // set PLIC Edge/Level
-    // 每个中断源都设置为Level类型
-    IOWR(PLIC_BASE, 0, 0x0);
+	alt_u32 rx;
+	alt_u32 decoded;
+	alt_u32 displayed;
+} kb_latency_sample;
+
+kb_latency_sample kb_samples[KB_SAMPLE_QUEUE_SIZE];
+alt_u32 kb_sample_head = 0;
+alt_u32 kb_sample_tail = 0;
+// samples lost because the stats task fell behind
+alt_u32 kb_samples_dropped = 0;
+#endif /* KB_LATENCY_STATS */
+
+int count = 0;
 
-    // set PLIC Interrupt Priority
-    // 每个中断源占4bit，7个中断源的优先级都设为1
-    IOWR(PLIC_BASE, 1, 0x01111111);
+void kb_detect_task(void* context);
+void kb_decode_task(void* context);
+void kb_display_task(void* context);
+#if KB_LATENCY_STATS
+void kb_stats_task(void* context);
+#endif
+void ms_frame_task(void* context);
 
-    // set PLIC Interrupt Enable
-    // 设置中断源[6]为enable
-    IOWR(PLIC_BASE, 2, 0x40);
+// timer callback, context is the task to post
+void kb_post(void* context)
+{
+    alt_sched_post((alt_u32)context);
+}
 
-    // set PLIC Priority Threshold
-    // 不屏蔽任何src
-    IOWR(PLIC_BASE, 3, 0x0);
+// steps detection once a tick until it is done
+alt_timer kb_detect_timer = ALT_TIMER_INIT(kb_post, (void*)KB_TASK_DETECT);
 
-    // Enable keyboard interrupts
-    alt_up_ps2_enable_read_interrupt(&ps2_keyboard_0);
+// runs the mouse task at the frame rate while a mouse is attached
+alt_timer ms_frame_timer = ALT_TIMER_INIT(kb_post, (void*)KB_TASK_MOUSE);
+
+void ridecore_init(void)
+{
+    // route traps through the vector table and install the handlers
+    alt_irq_init();
+    alt_irq_register(PS2_KEYBOARD_0_IRQ, &kb_ring, ps2_isr);
+
+#if KB_LATENCY_STATS
+    alt_sched_register(KB_TASK_STATS, kb_stats_task, NULL);
+#endif
+    alt_sched_register(KB_TASK_DECODE, kb_decode_task, NULL);
+    alt_sched_register(KB_TASK_MOUSE, ms_frame_task, NULL);
+    alt_sched_register(KB_TASK_DISPLAY, kb_display_task, NULL);
+    alt_sched_register(KB_TASK_DETECT, kb_detect_task, NULL);
+    ps2_irq_event = 1 << KB_TASK_DECODE;
+
+    // open(PS2_KEYBOARD_0_NAME) finds the device, read() takes from kb_ring
+    alt_up_ps2_set_ring(&ps2_keyboard_0, &kb_ring);
+    alt_dev_reg(&ps2_keyboard_0.dev);
+
+    // every source level triggered, priority 1, disabled; threshold 0
+    plic_init();
+    plic_enable(PS2_KEYBOARD_0_IRQ);
+
+    // software timers, ticking only while one is armed (command timeouts)
+    alt_timer_init();
+
+    // reset and detect the device, kb_detect_task() steps it to completion
+    alt_up_ps2_init_start(&ps2_keyboard_0);
+    alt_timer_arm(&kb_detect_timer, ALT_TIMER_TICK_US, ALT_TIMER_TICK_US);
+    alt_sched_post(KB_TASK_DETECT);
 
     // Enable global CPU interrupts
     ridecore_cpu_eint();
 }
 
-//helper function for get_next_state
-unsigned get_multi_byte_make_code_index(alt_u8 code)
-{
-	unsigned i;
-	for (i = 0; i < SCAN_CODE_NUM; i++ )
-	{
-		if ( multi_byte_make_code[i] == code )
-			return i;
-	}
-	return SCAN_CODE_NUM;
-}
+// mtime at the last detection step
+alt_u32 kb_detect_mtime = 0;
 
-//helper function for get_next_state
-unsigned get_single_byte_make_code_index(alt_u8 code)
+void kb_detect_task(void* context)
 {
-	unsigned i;
-	for (i = 0; i < SCAN_CODE_NUM; i++ )
-	{
-		if ( single_byte_make_code[i] == code )
-			return i;
-	}
-	return SCAN_CODE_NUM;
-}
+    alt_u32 mtime;
+
+    if (alt_up_ps2_init_step(&ps2_keyboard_0) == -EINPROGRESS) {
+        // a machine timer that does not count never fires kb_detect_timer:
+        // step again at once, the driver's timeouts run on mcycle
+        mtime = (alt_u32)clint_get_time();
+        if (mtime == kb_detect_mtime)
+            alt_sched_post(KB_TASK_DETECT);
+        kb_detect_mtime = mtime;
+        return;
+    }
+    alt_timer_cancel(&kb_detect_timer);
+
+    // Enable keyboard interrupts. Also when detection failed: a keyboard
+    // plugged in later still sends scan codes.
+    alt_up_ps2_enable_read_interrupt(&ps2_keyboard_0);
 
-//helper function for decode_scancode
-/* FSM Diagram (Main transitions)
- * Normal bytes: bytes that are not 0xF0 or 0xE0
-  +--<--+
-  |     |                                   
-  |     |
-  V    INIT ------ 0xF0 ----> BREAK CODE
-  |     |                         |
-  |     |         LONG_BREAK_CODE-+
-  |    0xE0      /                |
- Normal |       /                Normal
-  |     |     0xF0                |
-  |     V     /                   |
-  |    LONG  /                    V
-  |    CODE --- Normal -------> DONE
-  |          (long make code)    /|\
-  |                               |
-  +-------------------------------|
+    // the decoder expects scan code set 2; the replies are matched by
+    // ps2_isr, so keys typed meanwhile are not lost
+    if (ps2_keyboard_0.device_type != PS2_MOUSE)
+        alt_up_ps2_cmd_set_scan_code_set(&ps2_keyboard_0, 2);
+    else
+        alt_timer_arm(&ms_frame_timer, MS_FRAME_US, MS_FRAME_US);
+}
 
+/*
+ * Mouse pointer, in mouse counts from where it started
  */
-DECODE_STATE get_next_state(DECODE_STATE state, alt_u8 byte, 
-		KB_CODE_TYPE *decode_mode, alt_u8 *buf, char *ascii)
+alt_32 ms_x = 0;
+alt_32 ms_y = 0;
+// left button presses, kept apart from the key releases on the display
+alt_u32 ms_clicks = 0;
+
+void ms_frame_task(void* context)
 {
-	DECODE_STATE next_state = STATE_INIT;
-	unsigned idx = SCAN_CODE_NUM;
-	*ascii = 0;
-	switch (state)
-	{
-		case STATE_INIT:
-			if ( byte == 0xE0 )
-			{	
-				// this could be a long break code or a long make code
-				next_state = STATE_LONG_CODE;
-			}
-			else if (byte == 0xF0)
-			{
-				// it is a break code
-				next_state = STATE_BREAK_CODE;
-			}
-			else
-			{
-				// it is a normal make code
-				idx = get_single_byte_make_code_index(byte);
-				if ( (idx < 40 || idx == 68 || idx > 79) && ( idx != SCAN_CODE_NUM ) )
-				{
-					*decode_mode = KB_ASCII_MAKE_CODE;
-					*ascii = ascii_codes[idx];
-					*buf = byte;
-				}
-				else 
-				{
-					*decode_mode = KB_BINARY_MAKE_CODE;
-					*buf = byte;
-				}
-				next_state = STATE_DONE;
-			}
-			break;
-		case STATE_LONG_CODE:
-			if ( byte != 0xF0 && byte!= 0xE0)
-			{
-				*decode_mode = KB_LONG_BINARY_MAKE_CODE;
-				*buf = byte;
-				next_state = STATE_DONE;
-			}
-			else
-			{
-				*decode_mode = KB_BREAK_CODE;
-				next_state = STATE_LONG_BREAK_CODE;
-			}
-			break;
-		case STATE_BREAK_CODE:
-			if ( byte != 0xF0 && byte != 0xE0)
-			{
-				*decode_mode = KB_BREAK_CODE;
-				*buf = byte;
-				next_state = STATE_DONE;
-			}
-			else
-			{
-				next_state = STATE_BREAK_CODE;
-				*decode_mode = KB_BREAK_CODE;
-			}
-			break;
-		case STATE_LONG_BREAK_CODE:
-			if ( byte != 0xF0 && byte != 0xE0)
-			{
-				*decode_mode = KB_LONG_BREAK_CODE;
-				*buf = byte;
-				next_state = STATE_DONE;
-			}
-			else
-			{
-				next_state = STATE_LONG_BREAK_CODE;
-				*decode_mode = KB_LONG_BREAK_CODE;
-			}
-			break;
-		default:
-			*decode_mode = KB_INVALID_CODE;
-			next_state = STATE_INIT;
-	}
-	return next_state;
+    ms_event* events;
+    alt_u32 i, n;
+    static alt_u8 last_buttons = 0;
+
+    // the motion of a whole frame comes as one event, split only where
+    // the buttons changed
+    while ((n = ms_event_peek(&events)) != 0) {
+        for (i = 0; i < n; i++) {
+            ms_x += events[i].dx;
+            ms_y += events[i].dy;
+            if ((events[i].buttons & ~last_buttons) & MS_BUTTON_LEFT) {
+                ms_clicks++;
+            }
+            last_buttons = events[i].buttons;
+        }
+        ms_event_consume(n);
+    }
 }
 
-void translate_make_code(KB_CODE_TYPE decode_mode, alt_u8 makecode, char *str)
+void kb_display_task(void* context)
 {
-	unsigned idx;
-	switch (decode_mode)
-	{
-		case KB_ASCII_MAKE_CODE:
-			idx = get_single_byte_make_code_index(makecode);
-			strcpy(str, key_table[idx]);
-			break;
-		case KB_BINARY_MAKE_CODE:
-			idx = get_single_byte_make_code_index(makecode);
-			strcpy(str, key_table[idx]);
-			break;
-		case KB_LONG_BINARY_MAKE_CODE:
-			idx = get_multi_byte_make_code_index(makecode);
-			strcpy(str, key_table[idx]);
-			break;
-		default:
-            DISPLAY_CUT(++count);
-			str[0] = 0;
-			break;
-	}
-}
+    kb_event* events;
+    alt_u32 i, n;
+    char c;
+#if KB_LATENCY_STATS
+    kb_latency_sample* sample;
+    alt_u32 total = 0;
+    alt_u32 first = kb_sample_head;
+    alt_u32 displayed;
+#endif
+
+    // every queued event, also the ones that wrap around the queue end
+    while ((n = kb_event_peek(&events)) != 0) {
+        for (i = 0; i < n; i++) {
+            if (events[i].flags & KB_EVENT_BREAK) {
+                DISPLAY_CUT(++count);
+            }
+            else if (events[i].key != KEY_NONE) {
+                // characters, ENTER, BKSP and TAB go to the console, ESC
+                // clears it, other keys print nothing
+                c = key_descs[events[i].key].ascii;
+                if (c == 0x1b)
+                    console_clear();
+                else if (c != 0)
+                    console_putc(c);
+            }
+
+#if KB_LATENCY_STATS
+            // the histograms are updated later, by the stats task
+            if (kb_sample_head - kb_sample_tail >= KB_SAMPLE_QUEUE_SIZE) {
+                kb_samples_dropped++;
+                continue;
+            }
+            sample = &kb_samples[kb_sample_head++ & (KB_SAMPLE_QUEUE_SIZE - 1)];
+            sample->rx = events[i].cycle;
+            sample->decoded = events[i].decoded;
+#endif
+        }
+        kb_event_consume(n);
+#if KB_LATENCY_STATS
+        total += n;
+#endif
+    }
 
-void do_key_pressed(void) {
+    // the changed rows only, one store per changed display word
+    console_flush();
 
-    alt_u8 byte = READ_KB_BUFF(kb_rptr);
-    KB_CODE_TYPE decode_mode;
-    alt_u8 buf;
-    char ascii;
+#if KB_LATENCY_STATS
+    displayed = ridecore_cpu_get_cycle();
+    for (i = first; i != kb_sample_head; i++)
+        kb_samples[i & (KB_SAMPLE_QUEUE_SIZE - 1)].displayed = displayed;
+    if (total != 0)
+        alt_sched_post(KB_TASK_STATS);
+#endif
+}
 
-    decode_mode = KB_INVALID_CODE;
+#if KB_LATENCY_STATS
 
-    key_decode_state = get_next_state(key_decode_state, byte, &decode_mode, &buf, &ascii);
+void kb_stats_task(void* context)
+{
+    kb_latency_sample* sample;
 
-    if (key_decode_state == STATE_DONE) {
-        // decode
-        char str[10];
-        translate_make_code(decode_mode, buf, str);
+    while (kb_sample_tail != kb_sample_head) {
+        sample = &kb_samples[kb_sample_tail++ & (KB_SAMPLE_QUEUE_SIZE - 1)];
+        alt_hist_add(&kb_latency.rx_to_decode, sample->decoded - sample->rx);
+        alt_hist_add(&kb_latency.decode_to_display, sample->displayed - sample->decoded);
+        alt_hist_add(&kb_latency.rx_to_display, sample->displayed - sample->rx);
+    }
+}
 
-        // print;
-        int i = 0;
+void kb_wake_record(alt_u32 latency)
+{
+    kb_wake_stats.wakeups++;
+    kb_wake_stats.last = latency;
+    kb_wake_stats.total += latency;
+    if (latency < kb_wake_stats.min)
+        kb_wake_stats.min = latency;
+    if (latency > kb_wake_stats.max)
+        kb_wake_stats.max = latency;
+}
+#endif /* KB_LATENCY_STATS */
 
-        while (str[i] != 0) {
-            DISPLAY_CHAR(print_addr++, str[i++]);
+void kb_decode_task(void* context)
+{
+    alt_u8* data;
+    alt_u32* stamps;
+    alt_u32 n;
+
+    // no interrupt masking: the ISR only moves kb_ring.head
+    n = alt_ring_peek(&kb_ring, &data);
+    if (n == 0)
+        return;
+    stamps = alt_ring_peek_stamps(&kb_ring);
+
+    if (ps2_keyboard_0.device_type == PS2_MOUSE) {
+        // consumed by ms_frame_task, merged until then
+        ms_decode(data, stamps, n);
+        alt_ring_consume(&kb_ring, n);
+    }
+    else {
+        // at most one event per byte: decode no more bytes than the
+        // event queue has room for
+        if (n > kb_event_room())
+            n = kb_event_room();
+        if (n != 0) {
+            kb_decode(data, stamps, 1);
+#if KB_LATENCY_STATS
+            if (alt_sched_woken())
+                kb_wake_record(ridecore_cpu_get_cycle() - alt_irq_entry_cycle);
+#endif
+
+            kb_decode(data + 1, stamps ? stamps + 1 : NULL, n - 1);
+            alt_ring_consume(&kb_ring, n);
         }
-
-        key_decode_state = STATE_INIT;
+        alt_sched_post(KB_TASK_DISPLAY);
     }
 
-    kb_rptr++;
+    // the ring wrapped or the event queue is full: the rest follows the
+    // display task
+    if (alt_ring_count(&kb_ring) != 0)
+        alt_sched_post(KB_TASK_DECODE);
 }
 
 int main()
 {
-  int key_pressed;
-
   ridecore_init();
 
-  while(1) {
-    ridecore_cpu_dint();
-    key_pressed = (kb_rptr != kb_wptr) ? 1 : 0;
-    ridecore_cpu_eint();
-
-    if (key_pressed) {
-        do_key_pressed();
-    }
-  }
+  // detection, decode, display and stats run as their events are posted
+  alt_sched_run();
 
   return 0;
 }
@@ -0,0 +1,157 @@
+#include "HAL/inc/sys/alt_time.h"
+#include "mouse.h"
+
+/*
+ * Packet layout (3 bytes, a 4th with the wheel movement for ID 3):
+ *   byte 0  Y ovf | X ovf | Y sign | X sign | 1 | middle | right | left
+ *   byte 1  X movement, low 8 bits of a 9-bit two's complement value
+ *   byte 2  Y movement, the same
+ *   byte 3  Z movement, low 4 bits, two's complement
+ * Only bit 3 of byte 0 is fixed, so a byte without it cannot start a
+ * packet: it is dropped until one that can arrives. With receive times,
+ * a gap longer than MS_PACKET_GAP_US inside a packet also restarts it:
+ * the bytes of one packet follow each other within about a millisecond.
+ */
+
+#define MS_PACKET_GAP_CYCLES (MS_PACKET_GAP_US * ALT_CPU_CYCLES_PER_US)
+
+typedef char ms_event_queue_size_is_not_a_power_of_two
+	[(MS_EVENT_QUEUE_SIZE & (MS_EVENT_QUEUE_SIZE - 1)) ? -1 : 1];
+
+/*
+ * Mouse event queue, same scheme as the key event queue in keyboard.c
+ */
+static ms_event ms_events[MS_EVENT_QUEUE_SIZE];
+static volatile alt_u32 ms_event_head = 0;
+static volatile alt_u32 ms_event_tail = 0;
+
+ms_decode_stats ms_stats = { 0, 0, 0, 0 };
+
+static alt_u8 ms_packet[4];
+static alt_u32 ms_packet_pos = 0;
+static alt_u32 ms_packet_size = 3;
+static alt_u32 ms_packet_stamp = 0;
+
+// total + delta, clamped to [-max - 1, max]
+static alt_32 ms_add(alt_32 total, alt_32 delta, alt_32 max, alt_u8* flags)
+{
+	alt_32 sum = total + delta;
+
+	if (sum > max)
+	{
+		*flags |= MS_EVENT_CLAMPED;
+		return max;
+	}
+	if (sum < -max - 1)
+	{
+		*flags |= MS_EVENT_CLAMPED;
+		return -max - 1;
+	}
+	return sum;
+}
+
+static void ms_emit(void)
+{
+	alt_u32 head = ms_event_head;
+	alt_u8 b0 = ms_packet[0];
+	alt_u8 buttons = b0 & MS_PACKET_BUTTONS;
+	alt_32 dx = ms_packet[1] - ((b0 & MS_PACKET_X_SIGN) ? 256 : 0);
+	alt_32 dy = ms_packet[2] - ((b0 & MS_PACKET_Y_SIGN) ? 256 : 0);
+	alt_32 dz = 0;
+	ms_event* event;
+
+	if (ms_packet_size == 4)
+		dz = (alt_8)(ms_packet[3] << 4) >> 4;
+
+	ms_stats.packets++;
+
+	// merge into the newest event while it is queued and the buttons
+	// have not changed, so a click is never folded into a movement
+	if (head != ms_event_tail)
+	{
+		event = &ms_events[(head - 1) & (MS_EVENT_QUEUE_SIZE - 1)];
+		if (event->buttons == buttons)
+		{
+			event->dx = (alt_16)ms_add(event->dx, dx, 32767, &event->flags);
+			event->dy = (alt_16)ms_add(event->dy, dy, 32767, &event->flags);
+			event->dz = (alt_8)ms_add(event->dz, dz, 127, &event->flags);
+			if (event->packets != 255)
+				event->packets++;
+			if (b0 & (MS_PACKET_X_OVF | MS_PACKET_Y_OVF))
+				event->flags |= MS_EVENT_OVERFLOW;
+			ms_stats.merged++;
+			return;
+		}
+	}
+
+	if (head - ms_event_tail >= MS_EVENT_QUEUE_SIZE)
+	{
+		ms_stats.overflow++;
+		return;
+	}
+
+	event = &ms_events[head & (MS_EVENT_QUEUE_SIZE - 1)];
+	event->dx = (alt_16)dx;
+	event->dy = (alt_16)dy;
+	event->dz = (alt_8)dz;
+	event->buttons = buttons;
+	event->packets = 1;
+	event->flags = (b0 & (MS_PACKET_X_OVF | MS_PACKET_Y_OVF)) ? MS_EVENT_OVERFLOW : 0;
+
+	ms_event_head = head + 1;
+}
+
+void ms_set_packet_size(alt_u32 size)
+{
+	ms_packet_size = (size == 4) ? 4 : 3;
+	ms_packet_pos = 0;
+}
+
+void ms_decode(const alt_u8* data, const alt_u32* stamps, alt_u32 count)
+{
+	alt_u32 i;
+	alt_u8 byte;
+
+	for (i = 0; i < count; i++)
+	{
+		byte = data[i];
+		if (stamps)
+		{
+			if (ms_packet_pos != 0 && stamps[i] - ms_packet_stamp > MS_PACKET_GAP_CYCLES)
+			{
+				ms_stats.resyncs += ms_packet_pos;
+				ms_packet_pos = 0;
+			}
+			ms_packet_stamp = stamps[i];
+		}
+
+		if (ms_packet_pos == 0 && !(byte & MS_PACKET_SYNC))
+		{
+			ms_stats.resyncs++;
+			continue;
+		}
+
+		ms_packet[ms_packet_pos++] = byte;
+		if (ms_packet_pos == ms_packet_size)
+		{
+			ms_emit();
+			ms_packet_pos = 0;
+		}
+	}
+}
+
+alt_u32 ms_event_peek(ms_event** events)
+{
+	alt_u32 tail = ms_event_tail;
+	alt_u32 count = ms_event_head - tail;
+	alt_u32 offset = tail & (MS_EVENT_QUEUE_SIZE - 1);
+	alt_u32 contiguous = MS_EVENT_QUEUE_SIZE - offset;
+
+	*events = &ms_events[offset];
+	return (count < contiguous) ? count : contiguous;
+}
+
+void ms_event_consume(alt_u32 count)
+{
+	ms_event_tail += count;
+}
@@ -0,0 +1,123 @@
+#ifndef __MOUSE_H__
+#define __MOUSE_H__
+
+#include "HAL/inc/alt_types.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/*
+ * First byte of a movement packet
+ */
+#define MS_PACKET_BUTTONS  0x07
+// always 1: a first byte without it is out of sync
+#define MS_PACKET_SYNC     0x08
+#define MS_PACKET_X_SIGN   0x10
+#define MS_PACKET_Y_SIGN   0x20
+#define MS_PACKET_X_OVF    0x40
+#define MS_PACKET_Y_OVF    0x80
+
+/*
+ * Buttons
+ */
+#define MS_BUTTON_LEFT     0x01
+#define MS_BUTTON_RIGHT    0x02
+#define MS_BUTTON_MIDDLE   0x04
+
+/*
+ * Mouse event flags
+ */
+// a packet reported a movement out of the 9-bit range
+#define MS_EVENT_OVERFLOW  0x01
+// the accumulated movement was clamped to 16 bits
+#define MS_EVENT_CLAMPED   0x02
+
+/**
+ * @brief Decoded mouse event, 8 bytes. Consecutive movement packets with
+ * the same buttons are merged into one event until it is consumed.
+ **/
+typedef struct ms_event
+{
+	/// @brief movement to the right
+	alt_16 dx;
+	/// @brief movement up
+	alt_16 dy;
+	/// @brief scroll wheel movement, 4-byte packets only
+	alt_8 dz;
+	/// @brief MS_BUTTON_* buttons held down
+	alt_u8 buttons;
+	/// @brief number of packets merged into the event, saturates at 255
+	alt_u8 packets;
+	/// @brief combination of the MS_EVENT_* bits
+	alt_u8 flags;
+} ms_event;
+
+/*
+ * Size of the mouse event queue, must be a power of two
+ */
+#ifndef MS_EVENT_QUEUE_SIZE
+#define MS_EVENT_QUEUE_SIZE 8
+#endif
+
+/*
+ * Longest pause between two bytes of one packet
+ */
+#ifndef MS_PACKET_GAP_US
+#define MS_PACKET_GAP_US 2500
+#endif
+
+typedef struct
+{
+	/// @brief complete packets decoded
+	alt_u32 packets;
+	/// @brief bytes dropped to find the first byte of a packet again, or
+	/// because the rest of their packet came too late
+	alt_u32 resyncs;
+	/// @brief packets merged into an event that was still queued
+	alt_u32 merged;
+	/// @brief events dropped because the queue was full
+	alt_u32 overflow;
+} ms_decode_stats;
+
+extern ms_decode_stats ms_stats;
+
+/**
+ * @brief Set the packet size: 3 for a standard mouse, 4 for a mouse with
+ * a scroll wheel (device ID 3). Restarts packet synchronisation.
+ **/
+void ms_set_packet_size(alt_u32 size);
+
+/**
+ * @brief Run received bytes through the packet decoder.
+ *
+ * @param data -- the received bytes.
+ * @param stamps -- receive time (mcycle) of each byte, or NULL.
+ * @param count -- number of bytes at \em data.
+ *
+ * @note Run in the same context as the consumer: packets are merged into
+ * the newest queued event as long as it has not been consumed.
+ **/
+void ms_decode(const alt_u8* data, const alt_u32* stamps, alt_u32 count);
+
+/**
+ * @brief Look at the queued mouse events without removing them.
+ *
+ * @param events -- set to the oldest queued event.
+ *
+ * @return the number of events readable at \em events. Events that wrap
+ * around the end of the queue are returned by the next call.
+ **/
+alt_u32 ms_event_peek(ms_event** events);
+
+/**
+ * @brief Release \em count events returned by ms_event_peek().
+ **/
+void ms_event_consume(alt_u32 count);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __MOUSE_H__ */
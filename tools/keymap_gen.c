@@ -0,0 +1,161 @@
+/*
+ * keymap_gen -- host tool that generates keymap_tables.c
+ *
+ * The scan code tables below are the single source of truth for the
+ * keyboard layout. At build time they are turned into one compact
+ * descriptor per key, two 256-entry reverse index tables and the byte
+ * class table of the decode FSM, so the firmware can resolve a scan code
+ * with one load instead of a linear search over SCAN_CODE_NUM entries.
+ *
+ * Usage: keymap_gen > keymap_tables.c
+ */
+
+#include <stdio.h>
+
+#include "../keymap.h"
+
+////////////////////////////////////////////////////////////////////
+// Table of scan code, make code and their corresponding values 
+// These data are useful for developing more features for the keyboard 
+//
+static const char *key_table[SCAN_CODE_NUM] = { "A", "B", "C", "D", "E", "F", "G", "H", "I", 
+			"J", "K", "L", "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", 
+			"X", "Y", "Z", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "`", 
+			"-", "=", "\\", "BKSP", "SPACE", "TAB", "CAPS", "L SHFT", "L CTRL", 
+			"L GUI", "L ALT", "R SHFT", "R CTRL", "R GUI", "R ALT", "APPS", 
+			"ENTER", "ESC", "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", 
+			"F10", "F11", "F12", "SCROLL", "[", "INSERT", "HOME", "PG UP", 
+			"DELETE", "END", "PG DN", "U ARROW", "L ARROW", "D ARROW", "R ARROW", 
+			"NUM", "KP /", "KP *", "KP -", "KP +", "KP ENTER", "KP .", "KP 0", 
+			"KP 1", "KP 2", "KP 3", "KP 4", "KP 5", "KP 6", "KP 7", "KP 8", "KP 9", 
+			"]", ";", "'", ",", ".", "/" };
+
+static const char ascii_codes[SCAN_CODE_NUM] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 
+	'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 
+	'W', 'X', 'Y', 'Z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 
+	'`', '-', '=', 0, 0x08, ' ', 0x09, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x0A, 
+	0x1B, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, '[', 0, 0, 0, 0x7F, 0, 0, 
+	0, 0, 0, 0, 0, '/', '*', '-', '+', 0x0A, '.', '0', '1', '2', '3', '4', 
+	'5', '6', '7', '8', '9', ']', ';', '\'', ',', '.', '/' };
+
+static const alt_u8 single_byte_make_code[SCAN_CODE_NUM] = { 0x1C, 0x32, 0x21, 0x23, 0x24, 
+	0x2B, 0x34, 0x33, 0x43, 0x3B, 0x42, 0x4B, 0x3A, 0x31, 0x44, 0x4D, 0x15, 
+	0x2D, 0x1B, 0x2C, 0x3C, 0x2A, 0x1D, 0x22, 0x35, 0x1A, 0x45, 0x16, 0x1E, 
+	0x26, 0x25, 0x2E, 0x36, 0x3D, 0x3E, 0x46, 0x0E, 0x4E, 0x55, 0x5D, 0x66, 
+	0x29, 0x0D, 0x58, 0x12, 0x14, 0, 0x11, 0x59, 0, 0, 0, 0, 0x5A, 0x76, 
+	0x05, 0x06, 0x04, 0x0C, 0x03, 0x0B, 0x83, 0x0A, 0x01, 0x09, 0x78, 0x07, 
+	0x7E, 0x54, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x77, 0, 0x7C, 0x7B, 0x79, 0, 
+	0x71, 0x70, 0x69, 0x72, 0x7A, 0x6B, 0x73, 0x74, 0x6C, 0x75, 0x7D, 0x5B, 
+	0x4C, 0x52, 0x41, 0x49, 0x4A };
+
+static const alt_u8 multi_byte_make_code[SCAN_CODE_NUM] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1F, 0, 0, 0x14, 0x27, 0x11, 0x2F, 0, 
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x70, 0x6C, 0x7D, 0x71, 
+	0x69, 0x7A, 0x75, 0x6B, 0x72, 0x74, 0, 0x4A, 0, 0, 0, 0x5A, 0, 0, 0, 0, 
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+////////////////////////////////////////////////////////////////////
+
+// Keys whose make code decodes as KB_ASCII_MAKE_CODE
+#define IS_ASCII_KEY(idx)  ( (idx) < 40 || (idx) == 68 || (idx) > 79 )
+
+// "L SHFT" .. "R ALT" are consecutive and map to KB_MOD_LSHIFT .. KB_MOD_RALT
+#define FIRST_MODIFIER_KEY  44
+#define IS_MODIFIER_KEY(idx)  ( (idx) >= FIRST_MODIFIER_KEY && (idx) < FIRST_MODIFIER_KEY + 8 )
+
+static void print_string(const char *s)
+{
+	putchar('"');
+	for ( ; *s; s++ )
+	{
+		if ( *s == '"' || *s == '\\' )
+			putchar('\\');
+		putchar(*s);
+	}
+	putchar('"');
+}
+
+// build the reverse index; code 0 marks "no such make code" in the source tables
+static void build_index(const alt_u8 *make_code, alt_u8 *index)
+{
+	unsigned i;
+	for (i = 0; i < 256; i++ )
+		index[i] = KEY_NONE;
+	for (i = 0; i < SCAN_CODE_NUM; i++ )
+	{
+		// the first entry wins, like the linear search it replaces
+		if ( make_code[i] != 0 && index[make_code[i]] == KEY_NONE )
+			index[make_code[i]] = (alt_u8) i;
+	}
+}
+
+static void build_class(const alt_u8 *single_index, alt_u8 *class)
+{
+	unsigned i;
+	for (i = 0; i < 256; i++ )
+	{
+		if ( i == 0xE0 )
+			class[i] = KB_CLASS_E0;
+		else if ( i == 0xF0 )
+			class[i] = KB_CLASS_F0;
+		else if ( single_index[i] != KEY_NONE && IS_ASCII_KEY(single_index[i]) )
+			class[i] = KB_CLASS_ASCII;
+		else
+			class[i] = KB_CLASS_BINARY;
+	}
+}
+
+static void print_table(const char *name, const alt_u8 *index)
+{
+	unsigned i;
+	printf("const alt_u8 %s[256] = {", name);
+	for (i = 0; i < 256; i++ )
+	{
+		printf(i % 12 == 0 ? "\n\t" : " ");
+		printf("0x%02X%s", index[i], i == 255 ? "" : ",");
+	}
+	printf("\n};\n\n");
+}
+
+int main(void)
+{
+	alt_u8 single_index[256];
+	alt_u8 multi_index[256];
+	alt_u8 class[256];
+	unsigned i;
+
+	build_index(single_byte_make_code, single_index);
+	build_index(multi_byte_make_code, multi_index);
+	build_class(single_index, class);
+
+	printf("/* Generated by tools/keymap_gen.c -- do not edit. */\n\n");
+	printf("#include \"keymap.h\"\n\n");
+
+	printf("const key_desc key_descs[SCAN_CODE_NUM] = {\n");
+	for (i = 0; i < SCAN_CODE_NUM; i++ )
+	{
+		unsigned flags = 0;
+		unsigned modifier = 0;
+		if ( IS_ASCII_KEY(i) )
+			flags |= KEY_FLAG_ASCII;
+		if ( single_byte_make_code[i] != 0 )
+			flags |= KEY_FLAG_SINGLE;
+		if ( multi_byte_make_code[i] != 0 )
+			flags |= KEY_FLAG_EXTENDED;
+		if ( IS_MODIFIER_KEY(i) )
+			modifier = 1u << (i - FIRST_MODIFIER_KEY);
+
+		printf("\t{ ");
+		print_string(key_table[i]);
+		printf(", 0x%02X, 0x%02X, 0x%02X, 0x%02X },\n", (unsigned char) ascii_codes[i], flags,
+				single_byte_make_code[i] ? single_byte_make_code[i] : multi_byte_make_code[i],
+				modifier);
+	}
+	printf("};\n\n");
+
+	print_table("single_byte_key_index", single_index);
+	print_table("multi_byte_key_index", multi_index);
+	print_table("scan_code_class", class);
+
+	return 0;
+}
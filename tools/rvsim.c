@@ -0,0 +1,1227 @@
+/*
+ * rvsim -- rv32i + Zicsr instruction set simulator for cycle profiling
+ *
+ * Loads the firmware ELF (init) and runs it on a model of the board:
+ *
+ *   0x00000000  RAM (RVSIM_RAM_SIZE). Stores below DISPLAY_END go to the
+ *               character display instead, like on the board.
+ *   0x40000000  PLIC: edge/level, priorities (4 bits per source), enable,
+ *               threshold and claim/complete registers.
+ *   0x40000200  PS/2 port: data register with DATA, RVALID and RAVAIL,
+ *               control register with RE, RI and CE. Command bytes
+ *               written to the data register are answered with 0xFA
+ *               (0xFA 0xAA for reset), or set CE with -e, or go
+ *               unanswered with -q.
+ *   0x40000100  CLINT: mtime (the cycle count) and mtimecmp, raising the
+ *               machine timer interrupt while mtime >= mtimecmp.
+ *
+ * Scan codes (-t text, -x hex bytes) are fed to the PS/2 receive FIFO
+ * once the firmware has enabled the read interrupt, one byte every
+ * -i cycles, and raise PLIC source PS2_KEYBOARD_0_IRQ.
+ *
+ * Timing is a first-order in-order model (see CYC_*), not RIDECORE's
+ * superscalar pipeline: good for comparing code paths, not for absolute
+ * numbers. mcycle reads return the simulated cycle count.
+ *
+ * The run stops on ebreak, on a jump-to-self (alt_trap_halt), when the
+ * input is consumed and the CPU waits in WFI or has been idle for -w
+ * cycles, or after -c cycles. Instructions and cycles are then reported
+ * per function, hottest first, after the worst case interrupt latency
+ * (source pending to PLIC claim) per priority level.
+ *
+ * Usage: rvsim [-t text] [-x "1C F0 1C"] [-r repeat] [-i interval]
+ *              [-c max_cycles] [-w idle_cycles] [-n top] [-e] [-q]
+ *              [-d symbol[:words]] ... elf
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../keymap.h"
+#include "../HAL/inc/plic.h"
+#include "../HAL/inc/clint.h"
+
+typedef unsigned int u32;
+typedef int s32;
+typedef unsigned long long u64;
+
+#define RVSIM_RAM_SIZE  0x10000
+// stores to [0, DISPLAY_END) drive the character and count displays
+#define DISPLAY_END     0xa4
+
+#define PLIC_NUM_REGS       5
+#define PLIC_SOURCES    8
+#define PS2_CTRL        (PS2_KEYBOARD_0_BASE + 4)
+#define PS2_FIFO_SIZE   256
+// cycles before the modelled keyboard answers a command byte
+#define PS2_REPLY_DELAY 2000
+
+#define PS2_ACK         0xFA
+#define PS2_BAT_PASS    0xAA
+#define PS2_RESET       0xFF
+
+/*
+ * Cycle cost of each instruction class
+ */
+#define CYC_ALU         1
+#define CYC_LOAD        2
+#define CYC_STORE       1
+#define CYC_MMIO        4   // extra for device accesses
+#define CYC_BRANCH      1
+#define CYC_TAKEN       2   // extra for taken branches and jumps
+#define CYC_CSR         1
+#define CYC_TRAP        4
+
+#define MSTATUS_MIE     (1 << 3)
+#define MSTATUS_MPIE    (1 << 7)
+#define MIP_MEIP        (1 << MCAUSE_MEI)
+#define MIP_MTIP        (1 << MCAUSE_MTI)
+
+////////////////////////////////////////////////////////////////////
+// Machine state
+
+static unsigned char ram[RVSIM_RAM_SIZE];
+static char display[DISPLAY_END];
+
+static u32 x[32];
+static u32 pc;
+static u64 cycle;
+static u64 instret;
+static u64 interrupts;
+static u64 timer_interrupts;
+static u64 idle_cycles;
+
+static u32 csr_mstatus;
+static u32 csr_mie = MIP_MEIP;  // RIDECORE gates interrupts with mstatus.MIE only
+static u32 csr_mtvec;
+static u32 csr_mepc;
+static u32 csr_mcause;
+static u32 csr_mtval;
+static u32 csr_mscratch;
+
+static const char* stop_reason;
+
+////////////////////////////////////////////////////////////////////
+// Symbols
+
+typedef struct
+{
+	u32 addr;
+	u32 size;
+	char* name;
+	int code;
+	u64 insts;
+	u64 cycles;
+	u64 calls;
+} symbol;
+
+static symbol* syms;
+static int sym_num;
+// code symbols sorted by address, for the profile
+static symbol** code_syms;
+static int code_sym_num;
+
+static symbol* cur_sym;
+static u32 cur_lo, cur_hi;
+
+static int sym_cmp(const void* a, const void* b)
+{
+	const symbol* sa = *(symbol* const*)a;
+	const symbol* sb = *(symbol* const*)b;
+	return (sa->addr > sb->addr) - (sa->addr < sb->addr);
+}
+
+static symbol* find_symbol(const char* name)
+{
+	int i;
+
+	for (i = 0; i < sym_num; i++)
+	{
+		if (strcmp(syms[i].name, name) == 0)
+			return &syms[i];
+	}
+	return NULL;
+}
+
+// code symbol containing addr, cached as the range [cur_lo, cur_hi)
+static symbol* code_symbol(u32 addr)
+{
+	int lo = 0, hi = code_sym_num - 1, mid;
+
+	if (addr >= cur_lo && addr < cur_hi)
+		return cur_sym;
+
+	if (code_sym_num == 0 || addr < code_syms[0]->addr)
+	{
+		cur_sym = NULL;
+		cur_lo = 0;
+		cur_hi = code_sym_num ? code_syms[0]->addr : 0xFFFFFFFF;
+		return NULL;
+	}
+	while (lo < hi)
+	{
+		mid = (lo + hi + 1) / 2;
+		if (code_syms[mid]->addr <= addr)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+	cur_sym = code_syms[lo];
+	cur_lo = cur_sym->addr;
+	cur_hi = (lo + 1 < code_sym_num) ? code_syms[lo + 1]->addr : 0xFFFFFFFF;
+	return cur_sym;
+}
+
+////////////////////////////////////////////////////////////////////
+// ELF loader
+
+#define EI_CLASS        4
+#define ELFCLASS32      1
+#define EM_RISCV        243
+#define PT_LOAD         1
+#define SHT_SYMTAB      2
+#define SHF_EXECINSTR   0x4
+#define STT_NOTYPE      0
+#define STT_OBJECT      1
+#define STT_FUNC        2
+#define STB_GLOBAL      1
+
+typedef struct
+{
+	unsigned char e_ident[16];
+	unsigned short e_type, e_machine;
+	u32 e_version, e_entry, e_phoff, e_shoff, e_flags;
+	unsigned short e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx;
+} elf32_ehdr;
+
+typedef struct
+{
+	u32 p_type, p_offset, p_vaddr, p_paddr, p_filesz, p_memsz, p_flags, p_align;
+} elf32_phdr;
+
+typedef struct
+{
+	u32 sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link, sh_info, sh_addralign, sh_entsize;
+} elf32_shdr;
+
+typedef struct
+{
+	u32 st_name, st_value, st_size;
+	unsigned char st_info, st_other;
+	unsigned short st_shndx;
+} elf32_sym;
+
+static void fatal(const char* msg, const char* arg)
+{
+	fprintf(stderr, "rvsim: %s%s\n", msg, arg ? arg : "");
+	exit(1);
+}
+
+static void load_elf(const char* path)
+{
+	FILE* f = fopen(path, "rb");
+	unsigned char* image;
+	long len;
+	elf32_ehdr* eh;
+	elf32_phdr* ph;
+	elf32_shdr* sh;
+	elf32_sym* st;
+	const char* strtab;
+	int i, j, n, type;
+
+	if (f == NULL)
+		fatal("cannot open ", path);
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	image = malloc(len);
+	if (image == NULL || fread(image, 1, len, f) != (size_t)len)
+		fatal("cannot read ", path);
+	fclose(f);
+
+	eh = (elf32_ehdr*)image;
+	if (len < (long)sizeof(*eh) || memcmp(eh->e_ident, "\177ELF", 4) != 0 ||
+		eh->e_ident[EI_CLASS] != ELFCLASS32 || eh->e_machine != EM_RISCV)
+		fatal("not a 32-bit RISC-V ELF: ", path);
+
+	for (i = 0; i < eh->e_phnum; i++)
+	{
+		ph = (elf32_phdr*)(image + eh->e_phoff + i * eh->e_phentsize);
+		if (ph->p_type != PT_LOAD || ph->p_memsz == 0)
+			continue;
+		if (ph->p_paddr + ph->p_memsz > RVSIM_RAM_SIZE)
+			fatal("segment outside of RAM in ", path);
+		memcpy(ram + ph->p_paddr, image + ph->p_offset, ph->p_filesz);
+		memset(ram + ph->p_paddr + ph->p_filesz, 0, ph->p_memsz - ph->p_filesz);
+	}
+	pc = eh->e_entry;
+
+	sh = (elf32_shdr*)(image + eh->e_shoff);
+	for (i = 0; i < eh->e_shnum; i++)
+	{
+		if (sh[i].sh_type != SHT_SYMTAB)
+			continue;
+		st = (elf32_sym*)(image + sh[i].sh_offset);
+		strtab = (const char*)image + sh[sh[i].sh_link].sh_offset;
+		n = sh[i].sh_size / sizeof(elf32_sym);
+		syms = calloc(n, sizeof(symbol));
+		for (j = 0; j < n; j++)
+		{
+			type = st[j].st_info & 0xF;
+			if (type != STT_NOTYPE && type != STT_OBJECT && type != STT_FUNC)
+				continue;
+			if (st[j].st_name == 0 || st[j].st_shndx == 0 || st[j].st_shndx >= eh->e_shnum)
+				continue;
+			// skip local labels, assembler code counts under its global entry
+			if (strtab[st[j].st_name] == '.' || strtab[st[j].st_name] == '$')
+				continue;
+			if (type == STT_NOTYPE && (st[j].st_info >> 4) != STB_GLOBAL)
+				continue;
+			syms[sym_num].addr = st[j].st_value;
+			syms[sym_num].size = st[j].st_size;
+			syms[sym_num].name = strdup(strtab + st[j].st_name);
+			syms[sym_num].code = type != STT_OBJECT &&
+				(sh[st[j].st_shndx].sh_flags & SHF_EXECINSTR);
+			sym_num++;
+		}
+	}
+
+	code_syms = calloc(sym_num + 1, sizeof(symbol*));
+	for (i = 0; i < sym_num; i++)
+	{
+		if (!syms[i].code)
+			continue;
+		// one entry per address, the first name wins
+		for (j = 0; j < code_sym_num; j++)
+		{
+			if (code_syms[j]->addr == syms[i].addr)
+				break;
+		}
+		if (j == code_sym_num)
+			code_syms[code_sym_num++] = &syms[i];
+	}
+	qsort(code_syms, code_sym_num, sizeof(symbol*), sym_cmp);
+	free(image);
+}
+
+////////////////////////////////////////////////////////////////////
+// PS/2 port
+
+static unsigned char ps2_fifo[PS2_FIFO_SIZE];
+static u32 ps2_head, ps2_tail;
+static u32 ps2_ctrl;
+static int ps2_ce;
+static int ps2_error_mode;
+// -q: the keyboard ignores command bytes
+static int ps2_quiet_mode;
+static u64 ps2_overrun;
+
+// keyboard -> host bytes: scan codes, then the replies to commands
+static unsigned char* input;
+static u32 input_len, input_pos;
+static u32 input_interval = 2000;
+static u64 input_next;
+static int input_started;
+static u64 input_done_cycle;
+
+#define REPLY_MAX 16
+static struct { u64 at; unsigned char byte; } replies[REPLY_MAX];
+static int reply_num;
+
+static void ps2_push(unsigned char byte)
+{
+	if (ps2_head - ps2_tail >= PS2_FIFO_SIZE)
+	{
+		ps2_overrun++;
+		return;
+	}
+	ps2_fifo[ps2_head++ % PS2_FIFO_SIZE] = byte;
+}
+
+static void ps2_reply(unsigned char byte, u64 delay)
+{
+	if (reply_num < REPLY_MAX)
+	{
+		replies[reply_num].at = cycle + delay;
+		replies[reply_num].byte = byte;
+		reply_num++;
+	}
+}
+
+static u32 ps2_read_data(void)
+{
+	u32 avail = ps2_head - ps2_tail;
+
+	if (avail == 0)
+		return 0;
+	return (avail << 16) | (1 << 15) | ps2_fifo[ps2_tail++ % PS2_FIFO_SIZE];
+}
+
+static u32 ps2_read_ctrl(void)
+{
+	u32 ctrl = ps2_ctrl & 1;
+
+	if ((ctrl & 1) && ps2_head != ps2_tail)
+		ctrl |= 1 << 8;     // RI
+	if (ps2_ce)
+		ctrl |= 1 << 10;    // CE
+	return ctrl;
+}
+
+static void ps2_command(unsigned char byte)
+{
+	ps2_ce = ps2_error_mode;
+	if (ps2_ce || ps2_quiet_mode)
+		return;
+
+	ps2_reply(PS2_ACK, PS2_REPLY_DELAY);
+	if (byte == PS2_RESET)
+		ps2_reply(PS2_BAT_PASS, 2 * PS2_REPLY_DELAY);
+}
+
+// next cycle at which a byte arrives, ~0 if none
+static u64 ps2_next_event(void)
+{
+	u64 next = ~0ULL;
+	int i;
+
+	if (input_started && input_pos < input_len)
+		next = input_next;
+	for (i = 0; i < reply_num; i++)
+	{
+		if (replies[i].at < next)
+			next = replies[i].at;
+	}
+	return next;
+}
+
+static void ps2_update(void)
+{
+	int i;
+
+	// input starts once the firmware listens for it
+	if (!input_started && (ps2_ctrl & 1))
+	{
+		input_started = 1;
+		input_next = cycle + input_interval;
+	}
+	while (input_started && input_pos < input_len && cycle >= input_next)
+	{
+		ps2_push(input[input_pos++]);
+		input_next += input_interval;
+		if (input_pos == input_len)
+			input_done_cycle = cycle;
+	}
+	for (i = 0; i < reply_num; )
+	{
+		if (cycle >= replies[i].at)
+		{
+			ps2_push(replies[i].byte);
+			replies[i] = replies[--reply_num];
+		}
+		else
+			i++;
+	}
+}
+
+////////////////////////////////////////////////////////////////////
+// PLIC
+
+static u32 plic_reg[PLIC_NUM_REGS];
+static u32 plic_pending;
+static u32 plic_line;
+// claimed sources, most recent last
+static u32 plic_claimed[PLIC_SOURCES];
+static int plic_claim_num;
+static u32 plic_in_service;
+// sources waiting for a claim, and since when
+static u32 plic_ready;
+static u64 plic_ready_at[PLIC_SOURCES];
+
+// pending -> claim latency, per priority level of the claimed source
+typedef struct
+{
+	u64 claims;
+	u64 total;
+	u64 max;
+} irq_latency;
+
+static irq_latency plic_latency[PLIC_PRIORITY_MAX + 1];
+
+// stamp the sources that just became claimable, threshold aside
+static void plic_track(void)
+{
+	u32 ready = plic_pending & plic_reg[2] & ~plic_in_service;
+	u32 id;
+
+	for (id = 0; id < PLIC_SOURCES; id++)
+	{
+		if ((ready & ~plic_ready) & (1 << id))
+			plic_ready_at[id] = cycle;
+	}
+	plic_ready = ready;
+}
+
+static u32 plic_lines(void)
+{
+	u32 lines = 0;
+
+	if (ps2_read_ctrl() & (1 << 8))
+		lines |= 1 << PS2_KEYBOARD_0_IRQ;
+	return lines;
+}
+
+static void plic_update(void)
+{
+	u32 lines = plic_lines();
+	u32 edge = plic_reg[0];
+
+	// level sources follow the line, edge sources latch rising edges
+	plic_pending = (plic_pending & edge) | (lines & ~edge) | (lines & ~plic_line & edge);
+	plic_line = lines;
+	plic_track();
+}
+
+// highest priority claimable source, -1 if none
+static int plic_best(void)
+{
+	u32 id, prio, best_prio = 0;
+	u32 ready = plic_pending & plic_reg[2] & ~plic_in_service;
+	int best = -1;
+
+	for (id = 0; id < PLIC_SOURCES; id++)
+	{
+		if (!(ready & (1 << id)))
+			continue;
+		prio = (plic_reg[1] >> (id * 4)) & 0xF;
+		if (prio > plic_reg[3] && prio > best_prio)
+		{
+			best = id;
+			best_prio = prio;
+		}
+	}
+	return best;
+}
+
+static int plic_irq(void)
+{
+	return plic_best() >= 0;
+}
+
+static u32 plic_read_claim(void)
+{
+	int id = plic_best();
+
+	irq_latency* lat;
+
+	if (id < 0)
+		return 0;
+	lat = &plic_latency[(plic_reg[1] >> (id * 4)) & 0xF];
+	lat->claims++;
+	lat->total += cycle - plic_ready_at[id];
+	if (cycle - plic_ready_at[id] > lat->max)
+		lat->max = cycle - plic_ready_at[id];
+	plic_in_service |= 1 << id;
+	plic_pending &= ~((1 << id) & plic_reg[0]);
+	if (plic_claim_num < PLIC_SOURCES)
+		plic_claimed[plic_claim_num++] = id;
+	return id;
+}
+
+static void plic_write_complete(u32 id)
+{
+	int i;
+
+	// the firmware completes with 0: the most recent claim
+	if (id == 0 && plic_claim_num)
+		id = plic_claimed[plic_claim_num - 1];
+	for (i = plic_claim_num - 1; i >= 0; i--)
+	{
+		if (plic_claimed[i] == id)
+		{
+			memmove(&plic_claimed[i], &plic_claimed[i + 1], (plic_claim_num - i - 1) * sizeof(u32));
+			plic_claim_num--;
+			break;
+		}
+	}
+	plic_in_service &= ~(1 << id);
+	plic_track();
+}
+
+////////////////////////////////////////////////////////////////////
+// CLINT
+
+static u64 clint_timecmp = ~0ULL;
+
+static int clint_irq(void)
+{
+	return cycle >= clint_timecmp;
+}
+
+static u32 clint_read(u32 word)
+{
+	switch ((word - CLINT_BASE) >> 2)
+	{
+		case CLINT_REG_MTIME_LO:     return (u32)cycle;
+		case CLINT_REG_MTIME_HI:     return (u32)(cycle >> 32);
+		case CLINT_REG_MTIMECMP_LO:  return (u32)clint_timecmp;
+		default:                     return (u32)(clint_timecmp >> 32);
+	}
+}
+
+static void clint_write(u32 word, u32 data)
+{
+	// mtime follows the cycle count and ignores writes
+	if (((word - CLINT_BASE) >> 2) == CLINT_REG_MTIMECMP_LO)
+		clint_timecmp = (clint_timecmp & ~0xFFFFFFFFULL) | data;
+	else if (((word - CLINT_BASE) >> 2) == CLINT_REG_MTIMECMP_HI)
+		clint_timecmp = (clint_timecmp & 0xFFFFFFFFULL) | (u64)data << 32;
+}
+
+////////////////////////////////////////////////////////////////////
+// Bus
+
+static int bus_error;
+
+static int is_device(u32 addr)
+{
+	return addr >= PLIC_BASE;
+}
+
+static u32 device_read(u32 addr)
+{
+	u32 word = addr & ~3;
+
+	if (word == PS2_KEYBOARD_0_BASE)
+		return ps2_read_data();
+	if (word == PS2_CTRL)
+		return ps2_read_ctrl();
+	if (word == PLIC_CLAIM)
+		return plic_read_claim();
+	if (word >= PLIC_BASE && word < PLIC_BASE + PLIC_NUM_REGS * 4)
+		return plic_reg[(word - PLIC_BASE) >> 2];
+	if (word >= CLINT_BASE && word < CLINT_BASE + 16)
+		return clint_read(word);
+
+	bus_error = 1;
+	return 0;
+}
+
+static void device_write(u32 addr, u32 data)
+{
+	u32 word = addr & ~3;
+
+	if (word == PS2_KEYBOARD_0_BASE)
+		ps2_command((unsigned char)data);
+	else if (word == PS2_CTRL)
+		ps2_ctrl = data;
+	else if (word == PLIC_CLAIM)
+		plic_write_complete(data);
+	else if (word >= PLIC_BASE && word < PLIC_BASE + PLIC_NUM_REGS * 4)
+		plic_reg[(word - PLIC_BASE) >> 2] = data;
+	else if (word >= CLINT_BASE && word < CLINT_BASE + 16)
+		clint_write(word, data);
+	else
+		bus_error = 1;
+}
+
+static u32 load(u32 addr, int size)
+{
+	u32 v;
+
+	if (is_device(addr))
+	{
+		cycle += CYC_MMIO;
+		v = device_read(addr) >> ((addr & 3) * 8);
+	}
+	else if (addr + size <= RVSIM_RAM_SIZE)
+	{
+		v = ram[addr];
+		if (size > 1)
+			v |= ram[addr + 1] << 8;
+		if (size > 2)
+			v |= (u32)ram[addr + 2] << 16 | (u32)ram[addr + 3] << 24;
+	}
+	else
+	{
+		bus_error = 1;
+		return 0;
+	}
+	if (size == 1)
+		return v & 0xFF;
+	if (size == 2)
+		return v & 0xFFFF;
+	return v;
+}
+
+static void store(u32 addr, u32 data, int size)
+{
+	int i;
+
+	if (is_device(addr))
+	{
+		cycle += CYC_MMIO;
+		device_write(addr, data << ((addr & 3) * 8));
+		return;
+	}
+	if (addr + size > RVSIM_RAM_SIZE)
+	{
+		bus_error = 1;
+		return;
+	}
+	for (i = 0; i < size; i++, data >>= 8)
+	{
+		if (addr + i < DISPLAY_END)
+			display[addr + i] = (char)data;
+		else
+			ram[addr + i] = (unsigned char)data;
+	}
+}
+
+////////////////////////////////////////////////////////////////////
+// CPU
+
+static void trap(u32 cause, u32 epc, u32 tval)
+{
+	csr_mepc = epc;
+	csr_mcause = cause;
+	csr_mtval = tval;
+	csr_mstatus = (csr_mstatus & ~MSTATUS_MPIE) | ((csr_mstatus & MSTATUS_MIE) ? MSTATUS_MPIE : 0);
+	csr_mstatus &= ~MSTATUS_MIE;
+	pc = csr_mtvec & ~3;
+	if ((cause & MCAUSE_INTERRUPT) && (csr_mtvec & 1))
+		pc += (cause & ~MCAUSE_INTERRUPT) * 4;
+	cycle += CYC_TRAP;
+}
+
+static int csr_access(u32 id, u32* value, u32 wdata, int op)
+{
+	u32* reg = NULL;
+	u32 old;
+
+	switch (id)
+	{
+		case CSR_MSTATUS:  reg = &csr_mstatus; break;
+		case CSR_MIE:      reg = &csr_mie; break;
+		case CSR_MTVEC:    reg = &csr_mtvec; break;
+		case 0x340:        reg = &csr_mscratch; break;
+		case CSR_MEPC:     reg = &csr_mepc; break;
+		case CSR_MCAUSE:   reg = &csr_mcause; break;
+		case 0x343:        reg = &csr_mtval; break;
+		case 0x344:        // mip
+		case CSR_MCYCLE:
+		case CSR_MCYCLEH:
+		case 0xB02:        // minstret
+		case 0xB82:        // minstreth
+		case 0xC00:        // cycle
+		case 0xC80:        // cycleh
+		case 0xC02:        // instret
+		case 0xC82:        // instreth
+			break;
+		default:
+			return -1;
+	}
+
+	if (reg == NULL)
+	{
+		// read-only views
+		switch (id)
+		{
+			case 0x344:  old = (plic_irq() ? MIP_MEIP : 0) | (clint_irq() ? MIP_MTIP : 0); break;
+			case CSR_MCYCLE: case 0xC00:  old = (u32)cycle; break;
+			case CSR_MCYCLEH: case 0xC80: old = (u32)(cycle >> 32); break;
+			case 0xB02: case 0xC02:       old = (u32)instret; break;
+			default:                      old = (u32)(instret >> 32); break;
+		}
+		*value = old;
+		return 0;
+	}
+
+	old = *reg;
+	*value = old;
+	switch (op)
+	{
+		case 1: *reg = wdata; break;
+		case 2: *reg = old | wdata; break;
+		case 3: *reg = old & ~wdata; break;
+	}
+	return 0;
+}
+
+// execute one instruction, 0 to stop
+static int step(void)
+{
+	u32 inst, opcode, rd, rs1, rs2, funct3, funct7, a, b, v, next;
+	s32 imm = 0;
+	symbol* sym;
+	u64 start = cycle, idle = idle_cycles;
+	int taken = 0;
+
+	if (pc & 3 || pc + 4 > RVSIM_RAM_SIZE)
+	{
+		stop_reason = "instruction fetch outside of RAM";
+		return 0;
+	}
+
+	sym = code_symbol(pc);
+	inst = ram[pc] | ram[pc + 1] << 8 | (u32)ram[pc + 2] << 16 | (u32)ram[pc + 3] << 24;
+	opcode = inst & 0x7F;
+	rd = (inst >> 7) & 0x1F;
+	funct3 = (inst >> 12) & 0x7;
+	rs1 = (inst >> 15) & 0x1F;
+	rs2 = (inst >> 20) & 0x1F;
+	funct7 = inst >> 25;
+	a = x[rs1];
+	b = x[rs2];
+	next = pc + 4;
+	v = 0;
+
+	switch (opcode)
+	{
+		case 0x37:  // lui
+			v = inst & 0xFFFFF000;
+			cycle += CYC_ALU;
+			break;
+		case 0x17:  // auipc
+			v = pc + (inst & 0xFFFFF000);
+			cycle += CYC_ALU;
+			break;
+		case 0x6F:  // jal
+			imm = ((s32)(inst & 0x80000000) >> 11) | (inst & 0xFF000) |
+				((inst >> 9) & 0x800) | ((inst >> 20) & 0x7FE);
+			if (imm == 0 && rd == 0)
+			{
+				stop_reason = "jump to self";
+				return 0;
+			}
+			v = next;
+			next = pc + imm;
+			taken = 1;
+			cycle += CYC_BRANCH;
+			break;
+		case 0x67:  // jalr
+			imm = (s32)inst >> 20;
+			v = next;
+			next = (a + imm) & ~1;
+			taken = 1;
+			cycle += CYC_BRANCH;
+			break;
+		case 0x63:  // branches
+			imm = ((s32)(inst & 0x80000000) >> 19) | ((inst << 4) & 0x800) |
+				((inst >> 20) & 0x7E0) | ((inst >> 7) & 0x1E);
+			switch (funct3)
+			{
+				case 0: taken = a == b; break;
+				case 1: taken = a != b; break;
+				case 4: taken = (s32)a < (s32)b; break;
+				case 5: taken = (s32)a >= (s32)b; break;
+				case 6: taken = a < b; break;
+				case 7: taken = a >= b; break;
+				default: goto illegal;
+			}
+			if (taken)
+				next = pc + imm;
+			rd = 0;
+			cycle += CYC_BRANCH;
+			break;
+		case 0x03:  // loads
+			imm = (s32)inst >> 20;
+			switch (funct3)
+			{
+				case 0: v = (s32)(signed char)load(a + imm, 1); break;
+				case 1: v = (s32)(short)load(a + imm, 2); break;
+				case 2: v = load(a + imm, 4); break;
+				case 4: v = load(a + imm, 1); break;
+				case 5: v = load(a + imm, 2); break;
+				default: goto illegal;
+			}
+			cycle += CYC_LOAD;
+			break;
+		case 0x23:  // stores
+			imm = ((s32)inst >> 25 << 5) | rd;
+			switch (funct3)
+			{
+				case 0: store(a + imm, b, 1); break;
+				case 1: store(a + imm, b, 2); break;
+				case 2: store(a + imm, b, 4); break;
+				default: goto illegal;
+			}
+			rd = 0;
+			cycle += CYC_STORE;
+			break;
+		case 0x13:  // alu immediate
+		case 0x33:  // alu register
+			if (opcode == 0x13)
+			{
+				// shift amount and srai flag, or a sign-extended immediate
+				b = (funct3 == 1 || funct3 == 5) ? rs2 : (u32)((s32)inst >> 20);
+				if (funct3 != 5)
+					funct7 = 0;
+			}
+			else if (funct7 & ~0x20)
+				goto illegal;   // no M extension
+			switch (funct3)
+			{
+				case 0: v = funct7 ? a - b : a + b; break;
+				case 1: v = a << (b & 31); break;
+				case 2: v = (s32)a < (s32)b; break;
+				case 3: v = a < b; break;
+				case 4: v = a ^ b; break;
+				case 5: v = funct7 ? (u32)((s32)a >> (b & 31)) : a >> (b & 31); break;
+				case 6: v = a | b; break;
+				case 7: v = a & b; break;
+			}
+			cycle += CYC_ALU;
+			break;
+		case 0x0F:  // fence
+			rd = 0;
+			cycle += CYC_ALU;
+			break;
+		case 0x73:
+			cycle += CYC_CSR;
+			if (funct3 == 0)
+			{
+				rd = 0;
+				switch (inst >> 20)
+				{
+					case 0x000:     // ecall
+						instret++;
+						trap(11, pc, 0);
+						goto account;
+					case 0x001:     // ebreak
+						stop_reason = "ebreak";
+						return 0;
+					case 0x302:     // mret
+						csr_mstatus = (csr_mstatus & ~MSTATUS_MIE) |
+							((csr_mstatus & MSTATUS_MPIE) ? MSTATUS_MIE : 0);
+						csr_mstatus |= MSTATUS_MPIE;
+						next = csr_mepc;
+						taken = 1;
+						break;
+					case 0x105:     // wfi
+						plic_update();
+						while (!(plic_irq() && (csr_mie & MIP_MEIP)) &&
+							!(clint_irq() && (csr_mie & MIP_MTIP)))
+						{
+							u64 at = ps2_next_event();
+							if ((csr_mie & MIP_MTIP) && clint_timecmp < at)
+								at = clint_timecmp;
+							if (at == ~0ULL)
+							{
+								stop_reason = "idle in wfi, input consumed";
+								pc = next;
+								return 0;
+							}
+							if (at > cycle)
+							{
+								idle_cycles += at - cycle;
+								cycle = at;
+							}
+							ps2_update();
+							plic_update();
+						}
+						break;
+					default:
+						goto illegal;
+				}
+			}
+			else
+			{
+				u32 wdata = (funct3 & 4) ? rs1 : a;
+				int op = funct3 & 3;
+
+				// csrrs/csrrc with x0/0 do not write
+				if (op != 1 && wdata == 0)
+					op = 0;
+				if (csr_access(inst >> 20, &v, wdata, op) != 0)
+					goto illegal;
+			}
+			break;
+		default:
+			goto illegal;
+	}
+
+	if (bus_error)
+	{
+		bus_error = 0;
+		instret++;
+		trap(opcode == 0x03 ? 5 : 7, pc, a + imm);
+		goto account;
+	}
+
+	if (rd != 0)
+		x[rd] = v;
+	if (taken)
+		cycle += CYC_TAKEN;
+	pc = next;
+	instret++;
+
+account:
+	if (sym != NULL)
+	{
+		sym->insts++;
+		sym->cycles += cycle - start - (idle_cycles - idle);
+	}
+	return 1;
+
+illegal:
+	instret++;
+	trap(2, pc, inst);
+	goto account;
+}
+
+static void count_call(u32 from_pc)
+{
+	symbol* sym = code_symbol(pc);
+
+	(void)from_pc;
+	if (sym != NULL && sym->addr == pc)
+		sym->calls++;
+}
+
+static void run(u64 max_cycles, u64 idle_limit)
+{
+	u32 before;
+
+	while (cycle < max_cycles)
+	{
+		ps2_update();
+		plic_update();
+
+		if ((csr_mstatus & MSTATUS_MIE) && (csr_mie & MIP_MEIP) && plic_irq())
+		{
+			interrupts++;
+			trap(MCAUSE_INTERRUPT | MCAUSE_MEI, pc, 0);
+			count_call(0);
+		}
+		else if ((csr_mstatus & MSTATUS_MIE) && (csr_mie & MIP_MTIP) && clint_irq())
+		{
+			interrupts++;
+			timer_interrupts++;
+			trap(MCAUSE_INTERRUPT | MCAUSE_MTI, pc, 0);
+			count_call(0);
+		}
+
+		before = pc;
+		if (!step())
+			return;
+		if (pc != before + 4)
+			count_call(before);
+
+		if (input_started && input_pos == input_len && reply_num == 0 &&
+			ps2_head == ps2_tail && cycle - input_done_cycle > idle_limit)
+		{
+			stop_reason = "input consumed";
+			return;
+		}
+	}
+	stop_reason = "cycle limit";
+}
+
+////////////////////////////////////////////////////////////////////
+// Input
+
+static void add_input(unsigned char byte)
+{
+	static u32 size;
+
+	if (input_len == size)
+	{
+		size = size ? size * 2 : 256;
+		input = realloc(input, size);
+		if (input == NULL)
+			fatal("out of memory", NULL);
+	}
+	input[input_len++] = byte;
+}
+
+static void add_key(int k)
+{
+	const key_desc* key = &key_descs[k];
+
+	if (key->flags & KEY_FLAG_EXTENDED)
+		add_input(0xE0);
+	add_input(key->make_code);
+	if (key->flags & KEY_FLAG_EXTENDED)
+		add_input(0xE0);
+	add_input(0xF0);
+	add_input(key->make_code);
+}
+
+// make and break code of the key typing each character
+static void add_text(const char* text)
+{
+	int k;
+	char c;
+
+	for (; *text; text++)
+	{
+		c = (char)toupper((unsigned char)*text);
+		if (c == ' ')
+		{
+			for (k = 0; k < SCAN_CODE_NUM && strcmp(key_descs[k].name, "SPACE") != 0; k++)
+				;
+		}
+		else
+		{
+			for (k = 0; k < SCAN_CODE_NUM; k++)
+			{
+				if (key_descs[k].ascii == c && !(key_descs[k].flags & KEY_FLAG_EXTENDED))
+					break;
+			}
+		}
+		if (k == SCAN_CODE_NUM)
+			fprintf(stderr, "rvsim: no key for '%c'\n", *text);
+		else
+			add_key(k);
+	}
+}
+
+static void add_hex(const char* hex)
+{
+	char* end;
+	unsigned long v;
+
+	while (*hex)
+	{
+		v = strtoul(hex, &end, 16);
+		if (end == hex)
+			break;
+		add_input((unsigned char)v);
+		hex = end;
+	}
+}
+
+////////////////////////////////////////////////////////////////////
+// Report
+
+static int profile_cmp(const void* a, const void* b)
+{
+	const symbol* sa = *(symbol* const*)a;
+	const symbol* sb = *(symbol* const*)b;
+	return (sa->cycles < sb->cycles) - (sa->cycles > sb->cycles);
+}
+
+static void report(int top)
+{
+	int i;
+	symbol** order = malloc(code_sym_num * sizeof(symbol*));
+
+	printf("stop: %s at pc 0x%08x (%s)\n", stop_reason, pc,
+		code_symbol(pc) ? code_symbol(pc)->name : "?");
+	printf("%llu cycles, %llu instructions, %llu interrupts (%llu timer), %llu idle cycles\n",
+		cycle, instret, interrupts, timer_interrupts, idle_cycles);
+	printf("ps2: %u of %u input bytes sent, %llu overrun\n", input_pos, input_len, ps2_overrun);
+	if (csr_mcause && !(csr_mcause & MCAUSE_INTERRUPT))
+		printf("last exception: mcause %u mepc 0x%08x mtval 0x%08x\n", csr_mcause, csr_mepc, csr_mtval);
+
+	printf("display: \"");
+	for (i = 0; i < 0xa0; i++)
+		putchar(isprint((unsigned char)display[i]) ? display[i] : display[i] ? '.' : ' ');
+	printf("\"\ncount: %d\n\n", *(int*)&display[0xa0]);
+
+	printf("%8s %10s %10s %10s  (cycles from pending to claim)\n", "priority", "claims", "mean", "max");
+	for (i = PLIC_PRIORITY_MAX; i >= 0; i--)
+	{
+		if (plic_latency[i].claims)
+			printf("%8d %10llu %10llu %10llu\n", i, plic_latency[i].claims,
+				plic_latency[i].total / plic_latency[i].claims, plic_latency[i].max);
+	}
+	printf("\n");
+
+	memcpy(order, code_syms, code_sym_num * sizeof(symbol*));
+	qsort(order, code_sym_num, sizeof(symbol*), profile_cmp);
+
+	printf("%12s %6s %12s %10s  %s\n", "cycles", "%", "insts", "calls", "function");
+	for (i = 0; i < code_sym_num && i < top && order[i]->cycles; i++)
+	{
+		printf("%12llu %6.2f %12llu %10llu  %s\n", order[i]->cycles,
+			100.0 * order[i]->cycles / (cycle - idle_cycles ? cycle - idle_cycles : 1),
+			order[i]->insts, order[i]->calls, order[i]->name);
+	}
+	free(order);
+}
+
+static void dump(const char* spec)
+{
+	char name[128];
+	const char* colon = strchr(spec, ':');
+	u32 words = 1, i, addr;
+	symbol* sym;
+
+	snprintf(name, sizeof(name), "%.*s", colon ? (int)(colon - spec) : (int)strlen(spec), spec);
+	sym = find_symbol(name);
+	if (sym == NULL)
+	{
+		printf("%s: no such symbol\n", name);
+		return;
+	}
+	if (colon)
+		words = strtoul(colon + 1, NULL, 0);
+	else if (sym->size)
+		words = (sym->size + 3) / 4;
+
+	printf("%s @ 0x%08x:", name, sym->addr);
+	for (i = 0; i < words; i++)
+	{
+		addr = sym->addr + i * 4;
+		if (i % 8 == 0)
+			printf("\n ");
+		printf(" %08x", addr + 4 <= RVSIM_RAM_SIZE ? load(addr, 4) : 0);
+	}
+	printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+	u64 max_cycles = 200000000ULL, idle_limit = 200000;
+	u32 repeat = 1, r, base;
+	int top = 20, i, dump_num = 0;
+	const char* dumps[16];
+	const char* elf = NULL;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (argv[i][0] != '-' || argv[i][1] == 0 || argv[i][2] != 0)
+			elf = argv[i];
+		else if (argv[i][1] == 'e')
+			ps2_error_mode = 1;
+		else if (argv[i][1] == 'q')
+			ps2_quiet_mode = 1;
+		else if (i + 1 >= argc)
+			fatal("missing argument for ", argv[i]);
+		else switch (argv[i++][1])
+		{
+			case 't': add_text(argv[i]); break;
+			case 'x': add_hex(argv[i]); break;
+			case 'r': repeat = strtoul(argv[i], NULL, 0); break;
+			case 'i': input_interval = strtoul(argv[i], NULL, 0); break;
+			case 'c': max_cycles = strtoull(argv[i], NULL, 0); break;
+			case 'w': idle_limit = strtoull(argv[i], NULL, 0); break;
+			case 'n': top = atoi(argv[i]); break;
+			case 'd':
+				if (dump_num < 16)
+					dumps[dump_num++] = argv[i];
+				break;
+			default: fatal("unknown option ", argv[i - 1]);
+		}
+	}
+	if (elf == NULL)
+		fatal("usage: rvsim [-t text] [-x hex] [-r repeat] [-i interval] [-c cycles] "
+			"[-w idle] [-n top] [-e] [-q] [-d symbol[:words]] elf", NULL);
+
+	for (base = input_len, r = 1; r < repeat; r++)
+	{
+		for (i = 0; i < (int)base; i++)
+			add_input(input[i]);
+	}
+
+	load_elf(elf);
+	run(max_cycles, idle_limit);
+	report(top);
+	for (i = 0; i < dump_num; i++)
+		dump(dumps[i]);
+	return 0;
+}